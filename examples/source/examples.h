@@ -33,14 +33,19 @@ int audio_processing_main( int argc, char** argv );
 int video_reading_main( int argc, char** argv );
 int video_writing_main( int argc, char** argv );
 
+int json_benchmark_main( int argc, char** argv );
 int json_examples_main( int argc, char** argv );
 int json_tests_main( int argc, char** argv );
 
 int async_test_main( int argc, char** argv );
+int blob_storage_main( int argc, char** argv );
+int coroutines_main( int argc, char** argv );
 int dynamic_linking_main( int argc, char** argv );
 int encryption_main( int argc, char** argv );
 int fast_output_main( int argc, char** argv );
 int hashing_main( int argc, char** argv );
+int job_system_main( int argc, char** argv );
+int random_numbers_main( int argc, char** argv );
 int safety_test_main( int argc, char** argv );
 int sockets_main( int argc, char** argv );
 }
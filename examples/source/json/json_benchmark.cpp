@@ -0,0 +1,424 @@
+#include "examples.h"
+
+namespace js = kl::json;
+
+
+struct BoundPosition
+{
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+
+    KL_JSON_FIELDS( BoundPosition, x, y, z );
+};
+
+struct BoundRecord
+{
+    int64_t id = 0;
+    std::string name;
+    std::vector<std::string> tags;
+    BoundPosition position;
+    bool active = false;
+    std::optional<double> parent;
+
+    KL_JSON_FIELDS( BoundRecord, id, name, tags, position, active, parent );
+};
+
+struct BoundRecords
+{
+    std::vector<BoundRecord> records;
+
+    KL_JSON_FIELDS( BoundRecords, records );
+};
+
+static std::string generate_records( int record_count )
+{
+    std::stringstream stream;
+    stream << "{ \"records\": [";
+    for ( int i = 0; i < record_count; i++ )
+    {
+        stream << "{ \"id\": " << i;
+        stream << ", \"name\": \"record_" << i << "\"";
+        stream << ", \"tags\": [\"a\", \"b\\tc\", \"d\"]";
+        stream << ", \"position\": { \"x\": " << i * 0.5 << ", \"y\": " << -i * 0.25 << ", \"z\": 1e-3 }";
+        stream << ", \"active\": " << (i % 2 ? "true" : "false");
+        stream << ", \"parent\": null }";
+        if ( (i + 1) != record_count )
+            stream << ", ";
+    }
+    stream << "] }";
+    return stream.str();
+}
+
+static std::string generate_series( int sample_count )
+{
+    std::stringstream stream;
+    stream << "{ \"series\": [";
+    for ( int i = 0; i < sample_count; i++ )
+    {
+        stream << "[" << 1700000000000ll + i * 250ll << ", " << i * 0.125 << ", " << -i * 3 << "]";
+        if ( (i + 1) != sample_count )
+            stream << ", ";
+    }
+    stream << "] }";
+    return stream.str();
+}
+
+static std::string generate_lines( int line_count )
+{
+    std::stringstream stream;
+    for ( int i = 0; i < line_count; i++ )
+    {
+        stream << "{ \"id\": " << i << ", \"level\": \"" << (i % 3 ? "info" : "warn") << "\"";
+        stream << ", \"message\": \"request " << i << " done\", \"timings\": [" << i * 0.5 << ", 1.25, 3] }\n";
+    }
+    return stream.str();
+}
+
+static std::string generate_nested( int depth )
+{
+    std::string result;
+    for ( int i = 0; i < depth; i++ )
+        result += "{ \"child\": [";
+    for ( int i = 0; i < depth; i++ )
+        result += "] }";
+    return result;
+}
+
+template<typename F>
+static float time_it( F const& func )
+{
+    auto start_time = kl::time::now();
+    func();
+    return kl::time::elapsed( start_time );
+}
+
+static void compare( std::string_view const& name, std::string const& data )
+{
+    js::Object lexer_object;
+    float lexer_time = time_it( [&]
+    {
+        auto tokens = js::Lexer::parse( data );
+        lexer_object.compile( tokens.begin(), tokens.end() );
+    } );
+
+    js::Object parser_object;
+    float parser_time = time_it( [&]
+    {
+        js::Parser::parse( data, parser_object );
+    } );
+
+    float data_mb = data.size() / (1024.0f * 1024.0f);
+    kl::print( name, " (", data_mb, " MB)" );
+    kl::print( "  lexer + compile: ", lexer_time, "s, ", data_mb / lexer_time, " MB/s" );
+    kl::print( "  parser:          ", parser_time, "s, ", data_mb / parser_time, " MB/s" );
+    kl::print( "  results match:   ", lexer_object.decompile( -1 ) == parser_object.decompile( -1 ) ? "yes" : "no" );
+
+    std::string serialized;
+    float serialize_time = time_it( [&]
+    {
+        serialized = js::to_json( parser_object );
+    } );
+    size_t sink_size = 0;
+    float sink_time = time_it( [&]
+    {
+        js::Serializer<true> serializer{ [&]( std::string_view const& data )
+        {
+            sink_size += data.size();
+            return true;
+        } };
+        serializer.write( parser_object );
+    } );
+    kl::print( "  serialize:       ", serialize_time, "s, ", serialized.size() / (1024.0f * 1024.0f) / serialize_time, " MB/s" );
+    kl::print( "  pretty to sink:  ", sink_time, "s, ", sink_size / (1024.0f * 1024.0f) / sink_time, " MB/s" );
+
+    js::Document document;
+    float document_time = time_it( [&]
+    {
+        document.parse( data );
+    } );
+    kl::print( "  document:        ", document_time, "s, ", data_mb / document_time, " MB/s, ",
+        document.node_count(), " nodes in ", document.byte_size() / (1024.0f * 1024.0f), " MB" );
+
+    js::LazyDocument lazy_document;
+    float lazy_time = time_it( [&]
+    {
+        lazy_document.parse( data );
+    } );
+    std::string last_value;
+    float lookup_time = time_it( [&]
+    {
+        js::LazyView const values = lazy_document.root()[0];
+        last_value = values[values.size() - 1].source();
+    } );
+    kl::print( "  lazy index:      ", lazy_time, "s, ", data_mb / lazy_time, " MB/s" );
+    kl::print( "  lazy lookup:     ", lookup_time, "s for ", last_value.size(), " bytes" );
+
+    float tokens_time = time_it( [&]
+    {
+        js::Lexer::parse( data );
+    } );
+    float view_tokens_time = time_it( [&]
+    {
+        js::TokenDocument document{ data };
+    } );
+    size_t event_count = 0;
+    float stream_time = time_it( [&]
+    {
+        std::string_view remaining = data;
+        js::StreamParser stream{ [&]( char* buffer, uint64_t size )
+        {
+            uint64_t const count = std::min<uint64_t>( size, remaining.size() );
+            memcpy( buffer, remaining.data(), count );
+            remaining.remove_prefix( count );
+            return count;
+        } };
+        while ( stream.next_event().type != js::EventType::END )
+            event_count += 1;
+    } );
+    kl::print( "  stream events:   ", data_mb / stream_time, " MB/s, ", event_count, " events in ",
+        js::StreamParser::DEFAULT_CHUNK_SIZE / 1024, " KB chunks" );
+
+    kl::print( "  lexer tokens:    ", data_mb / tokens_time, " MB/s" );
+    kl::print( "  view tokens:     ", data_mb / view_tokens_time, " MB/s" );
+
+    static constexpr std::pair<js::ScannerLevel, std::string_view> scanner_levels[] = {
+        { js::ScannerLevel::SCALAR, "scalar" },
+        { js::ScannerLevel::SSE42, "sse4.2" },
+        { js::ScannerLevel::AVX2, "avx2" },
+    };
+    std::vector<size_t> indices;
+    for ( auto& [level, level_name] : scanner_levels )
+    {
+        if ( level > js::Scanner::best_level() )
+            continue;
+
+        js::Scanner::scan( data, level, indices );
+        float scan_time = time_it( [&]
+        {
+            js::Scanner::scan( data, level, indices );
+        } );
+        kl::print( "  scanner ", level_name, ": ", data_mb / scan_time, " MB/s" );
+    }
+}
+
+static void compare_binding( std::string const& data )
+{
+    BoundRecords records;
+    float read_time = time_it( [&]
+    {
+        js::from_json( data, records );
+    } );
+    std::string output;
+    float write_time = time_it( [&]
+    {
+        js::to_json( records, output );
+    } );
+
+    float data_mb = data.size() / (1024.0f * 1024.0f);
+    kl::print( "bound records (", records.records.size(), ")" );
+    kl::print( "  read:            ", read_time, "s, ", data_mb / read_time, " MB/s" );
+    kl::print( "  write:           ", write_time, "s, ", output.size() / (1024.0f * 1024.0f) / write_time, " MB/s" );
+}
+
+static void compare_objects( std::string const& data )
+{
+    static constexpr std::pair<js::KeyOrder, std::string_view> orders[] = {
+        { js::KeyOrder::SORTED, "sorted:   " },
+        { js::KeyOrder::INSERTION, "insertion:" },
+    };
+    kl::print( "object storage" );
+    for ( auto& [order, order_name] : orders )
+    {
+        js::Object object{ order };
+        float parse_time = time_it( [&]
+        {
+            js::Parser::parse( data, object );
+        } );
+
+        js::Array const& records = dynamic_cast<js::Array const&>(*object.at( "records" ));
+        int64_t checksum = 0;
+        float lookup_time = time_it( [&]
+        {
+            for ( auto& record : records )
+            {
+                js::Object const& fields = dynamic_cast<js::Object const&>(*record);
+                checksum += fields.at( "id" )->get_long().value_or( 0 );
+                checksum += fields.contains( "parent" ) + fields.at( "active" )->get_bool().value_or( false );
+            }
+        } );
+        kl::print( "  ", order_name, "      parse ", parse_time, "s, ", records.size() * 3 / lookup_time / 1e6f, " M lookups/s (", checksum, ")" );
+    }
+
+    js::Object reversed;
+    float build_time = time_it( [&]
+    {
+        for ( int i = 200000; i > 0; i-- )
+            reversed[kl::format( "key", i )] = js::make_number( i );
+        reversed.begin();
+    } );
+    kl::print( "  reverse build:   ", build_time, "s, ", reversed.size() / build_time / 1e6f, " M inserts/s" );
+}
+
+static void compare_columns( std::string const& data )
+{
+    std::string_view const rows = std::string_view{ data }.substr( data.find( '[' ), data.rfind( ']' ) - data.find( '[' ) + 1 );
+
+    std::vector<int64_t> ids;
+    std::vector<std::string> names;
+    float container_time = time_it( [&]
+    {
+        js::Array array{ rows };
+        for ( auto& row : array )
+        {
+            js::Object const& object = dynamic_cast<js::Object const&>(*row);
+            ids.push_back( object.at( "id" )->get_long().value_or( 0 ) );
+            names.push_back( object.at( "name" )->get_string().value_or( "" ) );
+        }
+    } );
+
+    js::ColumnArray columns{ { { "id", js::ColumnType::LONG }, { "name", js::ColumnType::STRING }, { "active", js::ColumnType::BOOL }, { "parent", js::ColumnType::DOUBLE } } };
+    float column_time = time_it( [&]
+    {
+        columns.decode( rows );
+    } );
+
+    float data_mb = rows.size() / (1024.0f * 1024.0f);
+    kl::print( "columns (", columns.row_count(), " rows, ", columns.errors().size(), " errors)" );
+    kl::print( "  array + copy:    ", container_time, "s, ", data_mb / container_time, " MB/s" );
+    kl::print( "  columnar:        ", column_time, "s, ", data_mb / column_time, " MB/s" );
+    kl::print( "  results match:   ", columns.column( "id" )->longs == ids ? "yes" : "no" );
+}
+
+static void compare_query( std::string const& data )
+{
+    js::Object const object{ data };
+    js::JsonPath const path{ "$.records[?(@.position.x < 1000)].name" };
+
+    std::vector<js::Container const*> manual;
+    float manual_time = time_it( [&]
+    {
+        for ( auto& row : dynamic_cast<js::Array const&>(*object.at( "records" )) )
+        {
+            js::Object const& record = dynamic_cast<js::Object const&>(*row);
+            auto position = record.find( "position" );
+            if ( position == record.end() )
+                continue;
+            js::Object const& coordinates = dynamic_cast<js::Object const&>(*position->second);
+            if ( coordinates.at( "x" )->get_double().value_or( 1000.0 ) < 1000.0 )
+                manual.push_back( &record.at( "name" ) );
+        }
+    } );
+
+    std::vector<js::Container const*> selected;
+    float query_time = time_it( [&]
+    {
+        path.select( object, selected );
+    } );
+
+    js::LazyDocument const lazy{ data };
+    std::vector<js::LazyView> views;
+    float lazy_time = time_it( [&]
+    {
+        path.select( lazy.root(), views );
+    } );
+
+    kl::print( "query (", selected.size(), " matches)" );
+    kl::print( "  hand written:    ", manual_time, "s" );
+    kl::print( "  json path:       ", query_time, "s" );
+    kl::print( "  lazy json path:  ", lazy_time, "s" );
+    kl::print( "  results match:   ", manual == selected && views.size() == selected.size() ? "yes" : "no" );
+}
+
+template<typename Codec>
+static void compare_codec( std::string_view const& name, js::Object const& object, size_t text_size )
+{
+    std::vector<byte> encoded;
+    float encode_time = time_it( [&]
+    {
+        Codec::encode( object, encoded );
+    } );
+    kl::Ref<js::Container> decoded;
+    float decode_time = time_it( [&]
+    {
+        decoded = Codec::decode( encoded );
+    } );
+
+    float data_mb = encoded.size() / (1024.0f * 1024.0f);
+    kl::print( "  ", name, " size: ", encoded.size(), " bytes (", 100.0f * encoded.size() / text_size, "% of text)" );
+    kl::print( "  ", name, " encode: ", encode_time, "s, ", data_mb / encode_time, " MB/s" );
+    kl::print( "  ", name, " decode: ", decode_time, "s, ", data_mb / decode_time, " MB/s" );
+    kl::print( "  ", name, " match: ", decoded && decoded->decompile( -1 ) == object.decompile( -1 ) ? "yes" : "no" );
+}
+
+static void compare_binary( std::string_view const& name, std::string const& data )
+{
+    js::Object object{ data };
+    std::string text;
+    float decompile_time = time_it( [&]
+    {
+        text = object.decompile( -1 );
+    } );
+    float parse_time = time_it( [&]
+    {
+        js::Object parsed{ text };
+    } );
+
+    float data_mb = text.size() / (1024.0f * 1024.0f);
+    kl::print( name, " binary (", text.size(), " text bytes)" );
+    kl::print( "  decompile:       ", decompile_time, "s, ", data_mb / decompile_time, " MB/s" );
+    kl::print( "  parse:           ", parse_time, "s, ", data_mb / parse_time, " MB/s" );
+    compare_codec<js::Cbor>( "cbor", object, text.size() );
+    compare_codec<js::MessagePack>( "msgpack", object, text.size() );
+}
+
+static void compare_ndjson( std::string const& data )
+{
+    size_t serial_count = 0;
+    float serial_time = time_it( [&]
+    {
+        for ( auto& line : kl::split_string( data, '\n' ) )
+        {
+            if ( line.empty() )
+                continue;
+            js::Object object{ line };
+            serial_count += 1;
+        }
+    } );
+
+    static constexpr std::pair<js::DeliveryOrder, std::string_view> orders[] = {
+        { js::DeliveryOrder::ORDERED, "ordered:  " },
+        { js::DeliveryOrder::UNORDERED, "unordered:" },
+    };
+    float data_mb = data.size() / (1024.0f * 1024.0f);
+    kl::print( "ndjson (", serial_count, " lines)" );
+    kl::print( "  serial:          ", serial_time, "s, ", data_mb / serial_time, " MB/s" );
+    for ( auto& [order, order_name] : orders )
+    {
+        std::atomic<uint64_t> count = 0;
+        float read_time = time_it( [&]
+        {
+            js::NdjsonReader::read( data, [&]( uint64_t line, kl::Ref<js::Container> const& value )
+            {
+                count += bool( value );
+            }, order );
+        } );
+        kl::print( "  ", order_name, "      ", read_time, "s, ", data_mb / read_time, " MB/s, ", count.load(), " values" );
+    }
+}
+
+int examples::json_benchmark_main( int argc, char** argv )
+{
+    std::string const records = generate_records( 200'000 );
+    compare( "records", records );
+    compare_binding( records );
+    compare_objects( records );
+    compare_columns( records );
+    compare_query( records );
+    compare_binary( "records", records );
+    compare_binary( "tests", R"({"data": 16, "person": {"name": "Krimzo", "ages": [22,23], "alive": true}, "escaped": "a\tb", "number": -1.5e3})" );
+    compare( "nested", generate_nested( 500 ) );
+    compare( "series", generate_series( 500'000 ) );
+    compare_ndjson( generate_lines( 200'000 ) );
+    return 0;
+}
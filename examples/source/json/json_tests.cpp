@@ -33,6 +33,84 @@ struct Person : js::ObjectSerializable
     }
 };
 
+struct BoundTransform
+{
+    kl::Float3 position;
+    kl::Float4x4 matrix;
+
+    KL_JSON_FIELDS( BoundTransform, position, matrix );
+};
+
+struct BoundEntity
+{
+    std::string name;
+    int64_t id = 0;
+    bool visible = false;
+    std::optional<double> weight;
+    std::vector<BoundTransform> transforms;
+
+    KL_JSON_FIELDS( BoundEntity, name, id, visible, weight, transforms );
+};
+
+struct EventRecorder
+{
+    std::string events;
+
+    bool on_object_start()
+    {
+        events += "{";
+        return true;
+    }
+
+    bool on_object_end()
+    {
+        events += "}";
+        return true;
+    }
+
+    bool on_array_start()
+    {
+        events += "[";
+        return true;
+    }
+
+    bool on_array_end()
+    {
+        events += "]";
+        return true;
+    }
+
+    bool on_key( std::string_view const& key )
+    {
+        events += kl::format( "k:", key, ";" );
+        return true;
+    }
+
+    bool on_null()
+    {
+        events += "n;";
+        return true;
+    }
+
+    bool on_bool( bool value )
+    {
+        events += value ? "t;" : "f;";
+        return true;
+    }
+
+    bool on_number( std::string_view const& value )
+    {
+        events += kl::format( "d:", value, ";" );
+        return true;
+    }
+
+    bool on_string( std::string_view const& value )
+    {
+        events += kl::format( "s:", value, ";" );
+        return true;
+    }
+};
+
 int examples::json_tests_main( int argc, char** argv )
 {
     auto test = []( js::Container const& container, std::string const& expected )
@@ -66,6 +144,326 @@ int examples::json_tests_main( int argc, char** argv )
     Person person{};
     person.from_container( obj_container );
     test( obj_container, person.to_container()->decompile( -1 ) );
+    test( js::Literal( R"("\u0041\u00e9\ud83d\ude00")" ), "\"A\xC3\xA9\xF0\x9F\x98\x80\"" );
+
+    test( js::Array( "[0.30000000000000004, 1e300, -0, 123456789012]" ), "[0.30000000000000004, 1e+300, 0, 123456789012]" );
+    test( js::Literal( "\"\\u0001 \\b\"" ), R"("\u0001 \b")" );
+
+    js::Object serialized{ R"({"b": [1, {"c": null}], "a": {"d": "e"}})" };
+    std::string const expected_pretty = "{\n  \"a\": {\n    \"d\": \"e\"\n  },\n  \"b\": [1, { \"c\": null }]\n}";
+    std::string const pretty = js::to_pretty_json( serialized );
+    if ( pretty != expected_pretty )
+    {
+        kl::print( "expected pretty: ", expected_pretty );
+        kl::print( "        but got: ", pretty );
+        exit( 1 );
+    }
+    std::string sink_output;
+    {
+        js::Serializer<> serializer{ [&]( std::string_view const& data )
+        {
+            sink_output.append( data );
+            return true;
+        }, 4 };
+        serializer.write( serialized );
+    }
+    test( serialized, sink_output );
+    {
+        int sink_calls = 0;
+        js::Serializer<> serializer{ [&]( std::string_view const& data )
+        {
+            sink_calls += 1;
+            return false;
+        }, 4 };
+        serializer.write( serialized );
+        serializer.write( serialized );
+        if ( serializer.flush() || !serializer.failed() || sink_calls != 1 )
+        {
+            kl::print( "serializer kept writing after its sink failed, sink was called ", sink_calls, " times" );
+            exit( 1 );
+        }
+    }
+
+    js::Document document{ R"({"data": 16, "person": {"name": "Krimzo", "ages": [22,23], "alive": true}})" };
+    test( *document.to_container(), R"({ "data": 16, "person": { "ages": [22, 23], "alive": true, "name": "Krimzo" } })" );
+    test( js::Literal( kl::format( '"', document.root()["person"]["name"].get_string().value_or( "" ), '"' ) ), R"("Krimzo")" );
+    test( *js::Document( js::Array( R"([null, "\n", { "x": -2.5 }])" ) ).to_container(), R"([null, "\n", { "x": -2.5 }])" );
+    test( *js::Document( R"({"id": 9007199254740993, "big": 18446744073709551615, "low": -9007199254740993})" ).to_container(),
+        R"({ "big": 18446744073709551615, "id": 9007199254740993, "low": -9007199254740993 })" );
+    test( *js::Document( js::Object( R"({"id": 9007199254740993})" ) ).to_container(), R"({ "id": 9007199254740993 })" );
+
+    std::string wide_source = "{";
+    for ( int i = 0; i < 40; i++ )
+        wide_source += kl::format( "\"k", (i * 7) % 40, "\": ", i, ", " );
+    wide_source += "\"k5\": -1}";
+    js::Document const wide{ wide_source };
+    for ( int i = 0; i < 40; i++ )
+    {
+        if ( wide.root()[kl::format( "k", (i * 7) % 40 )].get_long() != i )
+        {
+            kl::print( "document lookup of k", (i * 7) % 40, " didn't find ", i );
+            exit( 1 );
+        }
+    }
+    if ( wide.root()["k40"] || wide.root().key( 1 ) != "k7" )
+    {
+        kl::print( "document sorted keys changed the member order or found a missing key" );
+        exit( 1 );
+    }
+
+    js::LazyDocument lazy{ R"({"data": 16, "person": {"name": "Krimzo", "ages": [22,23], "a/b": {"~k": true}}})" };
+    test( *lazy.pointer( "/person/ages/1" ).materialize(), "23" );
+    test( *lazy.pointer( "/person/a~1b/~0k" ).materialize(), "true" );
+    test( *lazy.root()["person"]["name"].materialize(), R"("Krimzo")" );
+    test( *lazy.pointer( "/person/ages" ).to_container(), "[22, 23]" );
+    js::LazyDocument const lazy_nested{ R"({"id": 9007199254740993, "list": [{"x": [1, 2]}, "y"], "flag": false})" };
+    kl::Ref<js::Container> const lazy_copy = lazy_nested.to_container();
+    std::string const lazy_expected = R"({ "flag": false, "id": 9007199254740993, "list": [{ "x": [1, 2] }, "y"] })";
+    test( *lazy_copy, lazy_expected );
+    test( *js::Cbor::decode( js::Cbor::encode( *lazy_copy ) ), lazy_expected );
+    test( *js::MessagePack::decode( js::MessagePack::encode( *lazy_copy ) ), lazy_expected );
+    std::vector<js::Container const*> const lazy_selected = js::JsonPath( "$.list[0].x[1]" ).select( *lazy_copy );
+    if ( lazy_selected.size() != 1 || lazy_selected[0]->get_int() != 2 )
+    {
+        kl::print( "expected one selected value 2 from the lazy copy, but got ", lazy_selected.size(), " values" );
+        exit( 1 );
+    }
+    js::LazyView const lazy_list = lazy_nested.root()["list"];
+    if ( lazy_nested.root().size() != 3 || lazy_nested.root().key( 2 ) != "flag" || lazy_list.size() != 2 || lazy_list[1].get_string() != "y" || lazy_list[2] )
+    {
+        kl::print( "lazy children don't match: root size ", lazy_nested.root().size(), ", last key ", lazy_nested.root().key( 2 ), ", list size ", lazy_list.size() );
+        exit( 1 );
+    }
+
+    Person lazy_person{};
+    lazy_person.from_container( *js::LazyDocument( R"({ "name": "Krimzo", "skipped": [[{"age": 1}]], "age": 22.0 })" ).to_container() );
+    test( *lazy_person.to_container(), R"({ "age": 22, "name": "Krimzo" })" );
+
+    BoundEntity entity{};
+    bool const bound = js::from_json( R"({"id": 7, "unknown": {"x": [1]}, "name": "bo\"x", "weight": null, "visible": true,
+        "transforms": [{"position": [1, 2.5, -3], "matrix": [2, 0, 0, 0, 0, 2, 0, 0, 0, 0, 2, 0, 1, 2, 3, 1]}]})", entity );
+    std::string const expected_entity = R"({ "name": "bo\"x", "id": 7, "visible": true, "weight": null, "transforms": [{ "position": [1, 2.5, -3], "matrix": [2, 0, 0, 0, 0, 2, 0, 0, 0, 0, 2, 0, 1, 2, 3, 1] }] })";
+    std::string const entity_json = js::to_json( entity );
+    if ( !bound || entity_json != expected_entity )
+    {
+        kl::print( "binding returned: ", bound );
+        kl::print( " expected entity: ", expected_entity );
+        kl::print( "         but got: ", entity_json );
+        exit( 1 );
+    }
+    BoundEntity scaled_entity{};
+    if ( !js::from_json( R"({"id": 1.5e3})", scaled_entity ) || scaled_entity.id != 1500 || js::from_json( R"({"id": 1e300})", scaled_entity )
+        || js::from_json( R"({"id": 1e400})", scaled_entity ) )
+    {
+        kl::print( "integer binding accepted an out of range value or rejected 1.5e3, id is ", scaled_entity.id );
+        exit( 1 );
+    }
+    entity.weight = 2.5;
+    test( js::Object( js::to_json( entity ) ), R"({ "id": 7, "name": "bo\"x", "transforms": [{ "matrix": [2, 0, 0, 0, 0, 2, 0, 0, 0, 0, 2, 0, 1, 2, 3, 1], "position": [1, 2.5, -3] }], "visible": true, "weight": 2.5 })" );
+
+    js::Object binary_source{ R"({"int": -70000, "small": 5, "big": 1e300, "pi": 3.14159, "text": "é\n", "list": [null, true, false, [], {}], "long": "0123456789012345678901234567890123456789"})" };
+    test( *js::Cbor::decode( js::Cbor::encode( binary_source ) ), binary_source.decompile( -1 ) );
+    test( *js::MessagePack::decode( js::MessagePack::encode( binary_source ) ), binary_source.decompile( -1 ) );
+    test( *js::Cbor::decode( std::vector<byte>{ 0xBF, 0x61, 'a', 0x9F, 0x01, 0xF9, 0x3C, 0x00, 0xFF, 0xFF } ), R"({ "a": [1, 1] })" );
+    test( *js::Cbor::decode( std::vector<byte>{ 0x7F, 0x62, 'a', 'b', 0x61, 'c', 0xFF } ), R"("abc")" );
+    if ( js::Cbor::decode( std::vector<byte>( 100'000, 0x7F ) ) || js::Cbor::decode( std::vector<byte>{ 0x7F, 0x41, 'a', 0xFF } ) )
+    {
+        kl::print( "CBOR decoder accepted a nested or mismatched indefinite string chunk" );
+        exit( 1 );
+    }
+
+    test( js::Object( R"({"b": 1, "a": 2, "b": 3, "c": {"z": 0, "y": 1}})", js::KeyOrder::INSERTION ), R"({ "b": 3, "a": 2, "c": { "z": 0, "y": 1 } })" );
+    test( js::Object( R"({"b": 1, "a": 2, "b": 3})" ), R"({ "a": 2, "b": 3 })" );
+    js::Object large;
+    for ( int i = 0; i < 40; i++ )
+        large.insert_or_assign( kl::format( "key", 39 - i ), js::make_number( i ) );
+    large.erase( "key0" );
+    if ( large.size() != 39 || large.at( "key7" )->get_int() != 32 || large.contains( "key0" ) || large.begin()->first != "key1" )
+    {
+        kl::print( "expected 39 sorted keys from key1 with key7 = 32 and no key0" );
+        kl::print( "but got: ", large.decompile( -1 ) );
+        exit( 1 );
+    }
+    js::Object reversed;
+    for ( int i = 0; i < 20; i++ )
+        reversed[kl::format( "key", char( 'z' - i ) )] = js::make_number( i );
+    js::Object const reversed_copy = reversed;
+    if ( reversed_copy.begin()->first != "keyg" || reversed_copy.at( "keyz" )->get_int() != 0 || reversed.begin()->first != "keyg" )
+    {
+        kl::print( "expected a sorted copy of keys built in reverse, but got: ", reversed_copy.decompile( -1 ) );
+        exit( 1 );
+    }
+
+    js::ColumnArray columns{ { { "id", js::ColumnType::LONG }, { "price", js::ColumnType::DOUBLE }, { "name", js::ColumnType::STRING }, { "sold", js::ColumnType::BOOL } } };
+    bool const columns_read = columns.decode( R"([{"id": 1, "price": 2.5, "name": "a	b", "sold": true, "extra": [1]}, 7, {"id": "x"}, {"name": null, "id": 3}])" );
+    js::Column const& names = *columns.column( "name" );
+    auto test_columns = []( bool valid, std::string const& message )
+    {
+        if ( !valid )
+        {
+            kl::print( "column decoding: ", message );
+            exit( 1 );
+        }
+    };
+    test_columns( columns_read, "decode failed" );
+    test_columns( columns.row_count() == 2, kl::format( "expected 2 rows but got ", columns.row_count() ) );
+    test_columns( columns.errors().size() == 2 && columns.errors()[1].row == 2, kl::format( "expected errors in rows 1 and 2 but got ", columns.errors().size(), " errors" ) );
+    test_columns( columns.column( "id" )->longs == std::vector<int64_t>{ 1, 3 }, "id column is not [1, 3]" );
+    test_columns( columns.column( "price" )->present == std::vector<uint8_t>{ 1, 0 }, "price presence is not [1, 0]" );
+    test_columns( names.get_string( 0 ) == "a	b" && names.get_string( 1 ).empty(), kl::format( "expected names [\"a\tb\", \"\"] but got [\"", names.get_string( 0 ), "\", \"", names.get_string( 1 ), "\"]" ) );
+    test_columns( columns.column( "sold" )->bools == std::vector<uint8_t>{ 1, 0 }, "sold column is not [true, false]" );
+
+    js::Object store{ R"({"store": {"book": [{"title": "A", "price": 8.95}, {"title": "B", "price": 22.99, "isbn": "0-1"}, {"title": "C", "price": 12.5}], "bicycle": {"price": 19.95}}})" };
+    auto query = [&]( std::string_view const& path )
+    {
+        std::string result;
+        for ( auto& value : js::JsonPath( path ).select( store ) )
+            result += kl::format( result.empty() ? "" : ", ", value->decompile( -1 ) );
+        return js::Array( kl::format( '[', result, ']' ) );
+    };
+    test( query( "$.store.book[*].title" ), R"(["A", "B", "C"])" );
+    test( query( "$..price" ), "[19.95, 8.95, 22.99, 12.5]" );
+    test( query( "$.store.book[?(@.price < 20)].title" ), R"(["A", "C"])" );
+    test( query( "$.store.book[-1:].title" ), R"(["C"])" );
+    test( query( "$.store.book[?(@.isbn)]['title']" ), R"(["B"])" );
+    test( query( "$.store.book[0::2].price" ), "[8.95, 12.5]" );
+    test( query( "$.store['bicycle']" ), "[{ \"price\": 19.95 }]" );
+    std::string const store_source = store.decompile();
+    js::LazyDocument lazy_store{ store_source };
+    std::string lazy_titles;
+    for ( auto& value : js::JsonPath( "$..book[?(@.title != 'B')].title" ).select( lazy_store.root() ) )
+        lazy_titles += value.get_string().value_or( "" );
+    if ( lazy_titles != "AC" )
+    {
+        kl::print( "expected lazy titles: AC" );
+        kl::print( "             but got: ", lazy_titles );
+        exit( 1 );
+    }
+    if ( js::JsonPath( "$.store[" ) )
+    {
+        kl::print( "unterminated JSONPath selector was accepted" );
+        exit( 1 );
+    }
+
+    js::Object numbers{ R"({"id": 9007199254740993, "max": 18446744073709551615, "min": -9223372036854775808, "scaled": 1.5e3, "tiny": 1e-400, "bad": [1, 1e, 2]})" };
+    std::string const expected_numbers = R"({ "bad": [1, 2], "id": 9007199254740993, "max": 18446744073709551615, "min": -9223372036854775808, "scaled": 1500, "tiny": 0 })";
+    test( numbers, expected_numbers );
+    test( js::Literal( kl::format( numbers.at( "id" )->get_long().value_or( 0 ) ) ), "9007199254740993" );
+    test( *js::Cbor::decode( js::Cbor::encode( numbers ) ), expected_numbers );
+    test( *js::MessagePack::decode( js::MessagePack::encode( numbers ) ), expected_numbers );
+
+    std::string ndjson_lines;
+    auto ndjson_line = [&]( uint64_t line, kl::Ref<js::Container> const& value )
+    {
+        ndjson_lines += kl::format( line, ":", value ? value->decompile( -1 ) : "error", ";" );
+    };
+    auto test_ndjson = [&]( std::string const& expected_lines )
+    {
+        if ( ndjson_lines != expected_lines )
+        {
+            kl::print( "expected lines: ", expected_lines );
+            kl::print( "       but got: ", ndjson_lines );
+            exit( 1 );
+        }
+        ndjson_lines.clear();
+    };
+    js::NdjsonReader::read( "{\"a\": 1}\n\n[1, \"two\nlines\"]\r\n\"tail\"", ndjson_line );
+    test_ndjson( "0:{ \"a\": 1 };2:[1, \"two\\nlines\"];3:\"tail\";" );
+
+    std::string unbalanced_lines = "{\"a\": \"x}\n";
+    std::string expected_unbalanced = "0:error;";
+    for ( int i = 1; i <= 100; i++ )
+    {
+        unbalanced_lines += kl::format( "{\"b\": ", i, "}\n" );
+        expected_unbalanced += kl::format( i, ":{ \"b\": ", i, " };" );
+    }
+    js::NdjsonReader::read( unbalanced_lines, ndjson_line );
+    test_ndjson( expected_unbalanced );
+    std::string const ndjson_path = "json_tests.ndjson";
+    kl::write_file( ndjson_path, unbalanced_lines );
+    js::NdjsonReader::read( kl::File{ ndjson_path, false }, ndjson_line, js::DeliveryOrder::ORDERED, 64 );
+    std::filesystem::remove( ndjson_path );
+    test_ndjson( expected_unbalanced );
+
+    auto test_token = []( js::ViewToken const& token, js::TokenType type, std::string_view const& expected )
+    {
+        if ( token.type != type || token.value != expected )
+        {
+            kl::print( "expected token: ", expected );
+            kl::print( "      but got: ", token.value );
+            exit( 1 );
+        }
+        kl::print( "Test passed: ", token.value );
+    };
+
+    std::string const token_data = R"({ "plain": "text", "escaped": "a\tb", "number": -1.5e3 })";
+    js::TokenDocument tokens{ token_data };
+    test_token( tokens[1], js::TokenType::LIT_STRING, "plain" );
+    test_token( tokens[2], js::TokenType::LIT_STRING, "text" );
+    test_token( tokens[4], js::TokenType::LIT_STRING, "a\tb" );
+    test_token( tokens[6], js::TokenType::LIT_NUMBER, "-1.5e3" );
+    if ( tokens[2].value.data() != token_data.data() + token_data.find( "text" ) )
+    {
+        kl::print( "unescaped token does not view the source data" );
+        exit( 1 );
+    }
+
+    auto string_source = []( std::string_view data )
+    {
+        return [data]( char* buffer, uint64_t size ) mutable
+        {
+            uint64_t const count = std::min<uint64_t>( size, data.size() );
+            memcpy( buffer, data.data(), count );
+            data.remove_prefix( count );
+            return count;
+        };
+    };
+
+    std::string const stream_data = R"({ "skip": [1, {"a": [true]}], "long_key_name": "a\"b", "values": [null, false, 12345.678e-2, "\u00e9"] } trailing)";
+    EventRecorder expected_events;
+    js::Parser::parse_events( stream_data, expected_events );
+    for ( uint64_t chunk_size = 1; chunk_size <= 32; chunk_size *= 2 )
+    {
+        EventRecorder stream_events;
+        bool const result = js::StreamParser::parse_events( string_source( stream_data ), stream_events, chunk_size );
+        if ( !result || stream_events.events != expected_events.events )
+        {
+            kl::print( "expected events: ", expected_events.events );
+            kl::print( "       but got: ", stream_events.events );
+            exit( 1 );
+        }
+    }
+    kl::print( "Test passed: ", expected_events.events );
+
+    // Values that end exactly at the end of the input, at every position against the buffer edges.
+    for ( size_t padding = 0; padding < 40; padding++ )
+    {
+        for ( auto& [text, type, expected] : { std::tuple{ std::string( "42" ), js::EventType::LIT_NUMBER, "42" },
+            std::tuple{ std::string( "\"unterminated" ), js::EventType::LIT_STRING, "unterminated" } } )
+        {
+            std::string const data = std::string( padding, ' ' ) + text;
+            js::StreamParser parser{ string_source( data ), 1 };
+            js::StreamEvent const event = parser.next_event();
+            if ( event.type != type || event.value != expected )
+            {
+                kl::print( "expected stream value: ", expected );
+                kl::print( "              but got: ", event.value, " after ", padding, " spaces" );
+                exit( 1 );
+            }
+        }
+    }
+    kl::print( "Test passed: stream values at the end of the input" );
+
+    js::StreamParser stream{ string_source( stream_data ), 4 };
+    stream.next_event();
+    stream.next_event();
+    stream.skip_value();
+    if ( stream.next_event().value != "long_key_name" || stream.depth() != 1 )
+    {
+        kl::print( "stream parser failed to skip a value" );
+        exit( 1 );
+    }
+    kl::print( "Test passed: skip_value" );
 
     kl::print( "All tests passed!" );
     return 0;
@@ -28,9 +28,18 @@ static void for_test()
         data[i] = compute_function( i );
 }
 
-static void async_test()
+static void async_test( kl::Grain const& grain )
 {
     kl::async_for<int>( 0, (int) data.size(), [&]( int i )
+    {
+        data[i] = compute_function( i );
+    }, grain );
+}
+
+static void parallel_policy_test()
+{
+    std::ranges::iota_view view{ size_t( 0 ), data.size() };
+    std::for_each( std::execution::par, view.begin(), view.end(), [&]( size_t i )
     {
         data[i] = compute_function( i );
     } );
@@ -46,8 +55,29 @@ int examples::async_test_main( int argc, char** argv )
     kl::print( "for data[", index, "] = ", data[index], "\n" );
 
     clear_data();
-    kl::print( "kl::async_for time: ", time_it( async_test ) );
-    kl::print( "kl::async_for data[", index, "] = ", data[index], "\n" );
+    kl::print( "std::execution::par time: ", time_it( parallel_policy_test ) );
+    kl::print( "std::execution::par data[", index, "] = ", data[index], "\n" );
 
+    static constexpr std::pair<kl::Grain, std::string_view> grains[] = {
+        { { kl::GrainMode::AUTO }, "auto" },
+        { { kl::GrainMode::STATIC }, "static" },
+        { { kl::GrainMode::EXPLICIT, 4096 }, "explicit 4096" },
+    };
+    for ( auto& [grain, name] : grains )
+    {
+        clear_data();
+        kl::print( "kl::async_for ", name, " time: ", time_it( [&] { async_test( grain ); } ) );
+        kl::print( "kl::async_for ", name, " data[", index, "] = ", data[index], "\n" );
+    }
+
+    std::atomic<int> nested_count = 0;
+    kl::async_for( 0, 64, [&]( int )
+    {
+        kl::async_for( 0, 1000, [&]( int )
+        {
+            nested_count += 1;
+        } );
+    } );
+    kl::print( "nested kl::async_for: ", nested_count == 64'000 ? "ok" : "broken", " on ", kl::ThreadPool::global().thread_count(), " threads" );
     return 0;
 }
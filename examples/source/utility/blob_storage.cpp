@@ -0,0 +1,57 @@
+#include "examples.h"
+
+
+int examples::blob_storage_main( int argc, char** argv )
+{
+    std::string const directory = "blob_storage";
+    std::filesystem::remove_all( directory );
+
+    std::string asset( 8 * 1024 * 1024, 0 );
+    for ( size_t i = 0; i < asset.size(); i++ )
+        asset[i] = char( (i * 2654435761u) >> 13 );
+    std::string edited = asset;
+    edited.insert( 3'000'000, "an edit in the middle of the asset" );
+
+    kl::Hash asset_hash;
+    kl::Hash edited_hash;
+    {
+        kl::BlobStore store{ directory };
+        asset_hash = store.put( asset ).value();
+        edited_hash = store.put( edited ).value();
+        store.put( asset );
+
+        kl::BlobStats const stats = store.stats();
+        kl::print( stats.blob_count, " blobs, ", stats.chunk_count, " chunks, ", stats.logical_bytes / (1024.0f * 1024.0f), " MB logical, ",
+            stats.stored_bytes / (1024.0f * 1024.0f), " MB stored" );
+        kl::print( "keyed by content: ", asset_hash == kl::hash_str( asset ) ? "ok" : "broken" );
+    }
+
+    kl::BlobStore store{ directory };
+    kl::print( "reopened: ", store.read( asset_hash ) == asset && store.read( edited_hash ) == edited ? "ok" : "broken" );
+
+    store.remove( asset_hash );
+    store.remove( edited_hash );
+    uint64_t const kept_bytes = store.collect();
+    store.remove( asset_hash );
+    uint64_t const freed_bytes = store.collect();
+    kl::print( "collected: ", kept_bytes / (1024.0f * 1024.0f), " MB, then ", freed_bytes / (1024.0f * 1024.0f), " MB, ",
+        !store.contains( asset_hash ) && store.stats().stored_bytes == 0 ? "ok" : "broken" );
+
+    // A collect that got past renaming its new index to index.new is finished by the next open.
+    store.put( asset );
+    store.close();
+    std::filesystem::copy_file( directory + "/index.bin", directory + "/index.new" );
+    std::filesystem::copy_file( directory + "/pack.bin", directory + "/pack.tmp" );
+    kl::write_file( directory + "/index.bin", "interrupted" );
+    kl::write_file( directory + "/pack.bin", "" );
+    bool const recovered = store.open( directory ) && store.read( asset_hash ) == asset;
+    store.close();
+
+    std::filesystem::resize_file( directory + "/pack.bin", 1024 );
+    bool const truncated = !store.open( directory );
+    kl::print( "recovery: ", recovered && truncated ? "ok" : "broken" );
+
+    store.close();
+    std::filesystem::remove_all( directory );
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include "examples.h"
+
+
+static kl::Task<int> load_value( int value )
+{
+    co_await kl::resume_on();
+    co_return value * 2;
+}
+
+static kl::Task<int> sum_chain( int depth )
+{
+    // Every level awaits the next one, symmetric transfer keeps the stack flat.
+    if ( depth == 0 )
+        co_return 0;
+    co_return 1 + co_await sum_chain( depth - 1 );
+}
+
+static kl::Task<int> delayed_value( int value, float seconds )
+{
+    co_await kl::resume_after( seconds );
+    co_return value;
+}
+
+static kl::Task<void> failing_load()
+{
+    co_await kl::resume_on();
+    throw std::runtime_error( "asset is corrupted" );
+}
+
+static kl::Task<std::string> guarded_load()
+{
+    try
+    {
+        co_await failing_load();
+    }
+    catch ( std::exception const& exception )
+    {
+        co_return exception.what();
+    }
+    co_return "";
+}
+
+int examples::coroutines_main( int argc, char** argv )
+{
+    kl::print( "chain: ", kl::sync_wait( sum_chain( 100'000 ) ) == 100'000 ? "ok" : "broken" );
+
+    std::vector<kl::Task<int>> loads;
+    for ( int i = 0; i < 1000; i++ )
+        loads.push_back( load_value( i ) );
+    std::vector<int> const values = kl::sync_wait( kl::when_all( std::move( loads ) ) );
+    bool values_ok = values.size() == 1000;
+    for ( int i = 0; i < (int) values.size(); i++ )
+        values_ok = values_ok && values[i] == i * 2;
+    kl::print( "when_all: ", values_ok ? "ok" : "broken" );
+
+    auto [first, second] = kl::sync_wait( kl::when_all( load_value( 1 ), delayed_value( 7, 0.01f ) ) );
+    kl::print( "when_all tuple: ", first == 2 && second == 7 ? "ok" : "broken" );
+
+    std::vector<kl::Task<int>> racers;
+    racers.push_back( delayed_value( 1, 0.2f ) );
+    racers.push_back( delayed_value( 2, 0.02f ) );
+    racers.push_back( delayed_value( 3, 0.1f ) );
+    auto const [winner, winner_value] = kl::sync_wait( kl::when_any( std::move( racers ) ) );
+    kl::print( "when_any: ", winner == 1 && winner_value == 2 ? "ok" : "broken" );
+
+    bool empty_rejected = false;
+    try
+    {
+        kl::sync_wait( kl::when_any( std::vector<kl::Task<int>>{} ) );
+    }
+    catch ( std::invalid_argument const& )
+    {
+        empty_rejected = true;
+    }
+    kl::print( "when_any empty: ", empty_rejected ? "ok" : "broken" );
+
+    uint64_t const start_time = kl::time::now();
+    kl::sync_wait( delayed_value( 0, 0.05f ) );
+    float const slept = kl::time::elapsed( start_time );
+    kl::print( "resume_after: ", slept >= 0.05f && slept < 0.5f ? "ok" : "broken", ", ", slept, "s" );
+
+    kl::print( "errors: ", kl::sync_wait( guarded_load() ) == "asset is corrupted" ? "ok" : "broken" );
+
+    // Frames come from per-thread free lists, so spawning a lot of small tasks mostly skips the heap.
+    std::atomic<int> finished = 0;
+    auto counter = [&]() -> kl::Task<void>
+    {
+        co_await kl::resume_on();
+        finished += 1;
+    };
+    std::vector<kl::Task<void>> counters;
+    for ( int i = 0; i < 100'000; i++ )
+        counters.push_back( counter() );
+    uint64_t const spawn_time = kl::time::now();
+    kl::sync_wait( kl::when_all( std::move( counters ) ) );
+    kl::print( "spawn: ", finished == 100'000 ? "ok" : "broken", ", ", kl::time::elapsed( spawn_time ), "s for 100000 tasks" );
+    return 0;
+}
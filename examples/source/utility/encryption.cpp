@@ -12,18 +12,73 @@ int examples::encryption_main( int argc, char** argv )
     kl::print( data_0 );
     kl::print( data_1 );
 
-    encryptor.run_pass( data_0.data(), data_0.size() );
-    encryptor.run_pass( data_1 );
+    // Both values are one message, the second one continues the keystream where the first one ended.
+    encryptor.run_pass( data_0.data(), data_0.size(), 0 );
+    encryptor.run_pass( &data_1, sizeof( data_1 ), data_0.size() );
     kl::print<false>( kl::colors::ORANGE );
     kl::print( data_0 );
     kl::print( data_1 );
 
-    encryptor.run_pass( data_0.data(), data_0.size() );
-    encryptor.run_pass( data_1 );
+    encryptor.run_pass( data_0.data(), data_0.size(), 0 );
+    encryptor.run_pass( &data_1, sizeof( data_1 ), data_0.size() );
     kl::print<false>( kl::colors::CYAN );
     kl::print( data_0 );
     kl::print( data_1 );
 
     kl::print<false>( kl::colors::CONSOLE );
+
+    std::array<byte, kl::Encryptor::KEY_SIZE> key = {};
+    for ( size_t i = 0; i < key.size(); i++ )
+        key[i] = byte( i );
+    kl::Encryptor const reference{ key, { 0, 0, 0, 0, 0, 0, 0, 0x4a, 0, 0, 0, 0 } };
+    std::string sunscreen = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it.";
+    reference.run_pass( sunscreen.data(), sunscreen.size(), kl::Encryptor::BLOCK_SIZE );
+    static constexpr uint8_t expected[] = {
+        0x6e, 0x2e, 0x35, 0x9a, 0x25, 0x68, 0xf9, 0x80, 0x41, 0xba, 0x07, 0x28, 0xdd, 0x0d, 0x69, 0x81,
+        0xe9, 0x7e, 0x7a, 0xec, 0x1d, 0x43, 0x60, 0xc2, 0x0a, 0x27, 0xaf, 0xcc, 0xfd, 0x9f, 0xae, 0x0b,
+        0xf9, 0x1b, 0x65, 0xc5, 0x52, 0x47, 0x33, 0xab, 0x8f, 0x59, 0x3d, 0xab, 0xcd, 0x62, 0xb3, 0x57,
+        0x16, 0x39, 0xd6, 0x24, 0xe6, 0x51, 0x52, 0xab, 0x8f, 0x53, 0x0c, 0x35, 0x9f, 0x08, 0x61, 0xd8,
+        0x07, 0xca, 0x0d, 0xbf, 0x50, 0x0d, 0x6a, 0x61, 0x56, 0xa3, 0x8e, 0x08, 0x8a, 0x22, 0xb6, 0x5e,
+        0x52, 0xbc, 0x51, 0x4d, 0x16, 0xcc, 0xf8, 0x06, 0x81, 0x8c, 0xe9, 0x1a, 0xb7, 0x79, 0x37, 0x36,
+        0x5a, 0xf9, 0x0b, 0xbf, 0x74, 0xa3, 0x5b, 0xe6, 0xb4, 0x0b, 0x8e, 0xed, 0xf2, 0x78, 0x5e, 0x42,
+        0x87, 0x4d,
+    };
+    kl::print( "rfc 8439: ", sunscreen.size() == sizeof( expected ) && memcmp( sunscreen.data(), expected, sizeof( expected ) ) == 0 ? "ok" : "broken" );
+
+    std::string large( 256 * 1024 * 1024, 0 );
+    for ( size_t i = 0; i < large.size(); i++ )
+        large[i] = char( i * 31 );
+    std::string const original = large;
+
+    kl::Encryptor const large_encryptor;
+    auto start_time = kl::time::now();
+    large_encryptor.run_pass( large.data(), large.size(), 0 );
+    float const encrypt_time = kl::time::elapsed( start_time );
+
+    std::string pieces = original;
+    for ( size_t offset = 0; offset < pieces.size(); offset += 1'000'003 )
+        large_encryptor.run_pass( pieces.data() + offset, std::min<size_t>( 1'000'003, pieces.size() - offset ), offset );
+    bool const addressed = pieces == large;
+    large_encryptor.run_pass( large.data(), large.size(), 0 );
+    std::string overflow = "past the end";
+    bool const bounded = !large_encryptor.run_pass( overflow.data(), overflow.size(), kl::Encryptor::MAX_STREAM_SIZE - 4 ) && overflow == "past the end";
+    kl::print( "memory: ", addressed && bounded && large == original ? "ok" : "broken", ", ", large.size() / (1024.0f * 1024.0f) / encrypt_time, " MB/s" );
+
+    std::string const plain_path = "encryption_plain.bin";
+    std::string const cipher_path = "encryption_cipher.bin";
+    kl::Encryptor const file_encryptor;
+    kl::write_file( plain_path, original );
+    start_time = kl::time::now();
+    {
+        kl::File input{ plain_path, false };
+        kl::File output{ cipher_path, true };
+        file_encryptor.run_pass( input, output, 0 );
+    }
+    float const stream_time = kl::time::elapsed( start_time );
+    std::string streamed = kl::read_file( cipher_path );
+    file_encryptor.run_pass( streamed.data(), streamed.size(), 0 );
+    kl::print( "stream: ", streamed == original ? "ok" : "broken", ", ", original.size() / (1024.0f * 1024.0f) / stream_time, " MB/s" );
+    std::filesystem::remove( plain_path );
+    std::filesystem::remove( cipher_path );
     return 0;
 }
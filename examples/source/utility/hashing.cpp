@@ -9,5 +9,97 @@ int examples::hashing_main( int argc, char** argv )
     kl::print( kl::hash_str( some_text ) );
     kl::print( kl::hash_obj( some_data ) );
 
+    static constexpr std::pair<kl::HashLevel, std::string_view> levels[] = {
+        { kl::HashLevel::SCALAR, "scalar" },
+        { kl::HashLevel::AVX2, "avx2" },
+        { kl::HashLevel::SHA, "sha" },
+    };
+    kl::Hash const expected{ "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" };
+    std::string const message = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+
+    std::vector<std::string> records;
+    for ( int i = 0; i < 1'000'000; i++ )
+        records.push_back( kl::format( "record ", i, std::string( i % 200, 'x' ) ) );
+    std::vector<std::string_view> const views{ records.begin(), records.end() };
+    std::vector<kl::Hash> results( views.size() );
+    std::vector<kl::Hash> const reference = kl::hash_batch( views );
+    size_t const record_bytes = std::accumulate( records.begin(), records.end(), size_t( 0 ), []( size_t sum, std::string const& record )
+    {
+        return sum + record.size();
+    } );
+
+    std::string const large( 64 * 1024 * 1024, 'k' );
+    for ( auto& [level, name] : levels )
+    {
+        bool const supported = level == kl::HashLevel::SCALAR
+            || (level == kl::HashLevel::AVX2 && kl::cpu::has_avx2())
+            || (level == kl::HashLevel::SHA && kl::cpu::has_sha());
+        if ( !supported )
+            continue;
+
+        kl::Hasher hasher{ level };
+        for ( char c : message )
+            hasher.update( &c, 1 );
+        bool const streamed = hasher.finalize() == expected;
+
+        auto start_time = kl::time::now();
+        kl::hash_batch( views.data(), views.size(), results.data(), level );
+        float const batch_time = kl::time::elapsed( start_time );
+
+        start_time = kl::time::now();
+        hasher.update( large );
+        hasher.finalize();
+        float const large_time = kl::time::elapsed( start_time );
+
+        kl::print( name, ": streamed ", streamed ? "ok" : "broken", ", batch ", results == reference ? "ok" : "broken",
+            ", ", record_bytes / (1024.0f * 1024.0f) / batch_time, " MB/s for records, ",
+            large.size() / (1024.0f * 1024.0f) / large_time, " MB/s for one large buffer" );
+    }
+
+    std::string const filepath = "hashing_tree.bin";
+    std::string file_data = large + message;
+    kl::write_file( filepath, file_data );
+
+    auto start_time = kl::time::now();
+    std::optional<kl::TreeHash> tree = kl::tree_hash_file( filepath );
+    float const tree_time = kl::time::elapsed( start_time );
+    kl::TreeHash const memory_tree = kl::tree_hash( file_data.data(), file_data.size() );
+    kl::print( "tree: ", tree && tree->root == memory_tree.root ? "ok" : "broken", ", ", tree->chunks.size(), " chunks, ",
+        file_data.size() / (1024.0f * 1024.0f) / tree_time, " MB/s, root ", tree->root );
+
+    file_data[5'000'000] = 'x';
+    file_data += "appended";
+    kl::write_file( filepath, file_data );
+    kl::TreeHash const old_tree = tree.value();
+    kl::rehash_file_range( tree.value(), filepath, 5'000'000, 1 );
+    std::vector<uint64_t> const changed = kl::changed_chunks( old_tree, tree.value() );
+    bool const rehashed = tree->root == kl::tree_hash( file_data.data(), file_data.size() ).root && changed == std::vector<uint64_t>{ 4, 64 };
+    kl::print( "tree rehash: ", rehashed ? "ok" : "broken" );
+    std::filesystem::remove( filepath );
+
+    static constexpr auto long_text = []
+    {
+        std::array<char, 5000> result = {};
+        for ( size_t i = 0; i < result.size(); i++ )
+            result[i] = char( 'a' + (i * 7) % 26 );
+        return result;
+    }();
+    constexpr uint64_t literal_hash = kl::hash_str_fast( "cache key" );
+    constexpr uint64_t long_hash = kl::hash_str_fast( { long_text.data(), long_text.size() } );
+    std::string const runtime_key = kl::format( "cache", ' ', "key" );
+    std::string const runtime_text{ long_text.data(), long_text.size() };
+    bool const constant = literal_hash == kl::hash_str_fast( runtime_key ) && long_hash == kl::hash_str_fast( runtime_text )
+        && kl::hash_str_fast( runtime_key, 1 ) != literal_hash && kl::hash128_fast( runtime_key.data(), runtime_key.size() ).low == literal_hash;
+
+    uint64_t fast_sum = 0;
+    start_time = kl::time::now();
+    for ( auto& view : views )
+        fast_sum += kl::hash_str_fast( view );
+    float const fast_records_time = kl::time::elapsed( start_time );
+    start_time = kl::time::now();
+    fast_sum += kl::hash_str_fast( large );
+    float const fast_large_time = kl::time::elapsed( start_time );
+    kl::print( "fast: constexpr ", constant ? "ok" : "broken", ", ", record_bytes / (1024.0f * 1024.0f) / fast_records_time, " MB/s for records, ",
+        large.size() / (1024.0f * 1024.0f) / fast_large_time, " MB/s for one large buffer (", fast_sum % 10, ")" );
     return 0;
 }
@@ -0,0 +1,118 @@
+#include "examples.h"
+
+
+static constexpr int asset_count = 64;
+static constexpr int asset_size = 200'000;
+
+static float load_asset( std::vector<float>& asset, int index )
+{
+    asset.resize( asset_size );
+    for ( int i = 0; i < asset_size; i++ )
+        asset[i] = sin( float( index * asset_size + i ) );
+    return asset.front();
+}
+
+static void decode_asset( std::vector<float>& asset )
+{
+    for ( auto& value : asset )
+        value = sqrt( abs( value ) );
+}
+
+static float process_asset( std::vector<float> const& asset )
+{
+    return std::accumulate( asset.begin(), asset.end(), 0.0f );
+}
+
+int examples::job_system_main( int argc, char** argv )
+{
+    std::vector<std::vector<float>> assets( asset_count );
+    std::vector<float> sums( asset_count );
+
+    auto start_time = kl::time::now();
+    for ( int i = 0; i < asset_count; i++ )
+    {
+        load_asset( assets[i], i );
+        decode_asset( assets[i] );
+        sums[i] = process_asset( assets[i] );
+    }
+    float const serial_scene = std::accumulate( sums.begin(), sums.end(), 0.0f );
+    float const serial_time = kl::time::elapsed( start_time );
+
+    // Every asset is a load -> decode -> process chain, the scene waits for all of them.
+    kl::TaskGraph graph;
+    float graph_scene = 0.0f;
+    std::atomic<int> order_errors = 0;
+    std::vector<std::atomic<int>> stages( asset_count );
+    std::vector<kl::TaskGraph::ID> processed;
+    for ( int i = 0; i < asset_count; i++ )
+    {
+        kl::TaskGraph::ID const load = graph.add( [&, i]
+        {
+            load_asset( assets[i], i );
+            stages[i] = 1;
+        } );
+        kl::TaskGraph::ID const decode = graph.then( load, [&, i]
+        {
+            order_errors += stages[i] != 1;
+            decode_asset( assets[i] );
+            stages[i] = 2;
+        } );
+        processed.push_back( graph.then( decode, [&, i]
+        {
+            order_errors += stages[i] != 2;
+            sums[i] = process_asset( assets[i] );
+            stages[i] = 3;
+        } ) );
+    }
+    kl::TaskGraph::ID const scene = graph.add( [&]
+    {
+        for ( auto& stage : stages )
+            order_errors += stage != 3;
+        graph_scene = std::accumulate( sums.begin(), sums.end(), 0.0f );
+    } );
+    for ( kl::TaskGraph::ID id : processed )
+        graph.depend( scene, id );
+
+    start_time = kl::time::now();
+    graph.run();
+    graph.wait();
+    float const graph_time = kl::time::elapsed( start_time );
+    kl::print( "pipeline: ", graph_scene == serial_scene && order_errors == 0 ? "ok" : "broken", ", serial ", serial_time, "s, graph ", graph_time,
+        "s on ", kl::ThreadPool::global().thread_count(), " threads" );
+
+    for ( auto& stage : stages )
+        stage = 0;
+    start_time = kl::time::now();
+    graph.run();
+    graph.wait();
+    kl::print( "rerun: ", graph_scene == serial_scene && order_errors == 0 ? "ok" : "broken", ", ", kl::time::elapsed( start_time ), "s" );
+
+    graph.clear();
+    kl::TaskGraph::ID const failing = graph.add( []
+    {
+        throw std::runtime_error( "asset is corrupted" );
+    } );
+    bool skipped = true;
+    graph.then( failing, [&]
+    {
+        skipped = false;
+    } );
+    std::string error;
+    graph.run();
+    try
+    {
+        graph.wait();
+    }
+    catch ( std::exception const& exception )
+    {
+        error = exception.what();
+    }
+    kl::print( "errors: ", error == "asset is corrupted" && skipped ? "ok" : "broken" );
+
+    graph.clear();
+    kl::TaskGraph::ID const first = graph.add( [] {} );
+    kl::TaskGraph::ID const second = graph.then( first, [] {} );
+    graph.depend( first, second );
+    kl::print( "cycles: ", !graph.run() ? "ok" : "broken" );
+    return 0;
+}
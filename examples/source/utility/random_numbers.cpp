@@ -0,0 +1,109 @@
+#include "examples.h"
+
+
+template<typename F>
+static float time_it( F const& func )
+{
+    auto start_time = kl::time::now();
+    func();
+    return kl::time::elapsed( start_time );
+}
+
+int examples::random_numbers_main( int argc, char** argv )
+{
+    static constexpr int sample_count = 100'000'000;
+
+    kl::random::seed( 1234 );
+    std::vector<int> const first = { kl::random::gen_int( 1000 ), kl::random::gen_int( 1000 ), kl::random::gen_int( 1000 ) };
+    kl::random::seed( 1234 );
+    std::vector<int> const second = { kl::random::gen_int( 1000 ), kl::random::gen_int( 1000 ), kl::random::gen_int( 1000 ) };
+    kl::print( "seeded: ", first == second ? "ok" : "broken" );
+
+    // A range of 3 * 2^30 is where a plain modulo is visibly biased, the lower third gets twice the samples.
+    static constexpr uint32_t biased_range = 3u << 30;
+    kl::Xoshiro256 engine{ 42 };
+    int low_count = 0;
+    for ( int i = 0; i < 1'000'000; i++ )
+        low_count += kl::random::gen_bounded( engine, biased_range ) < biased_range / 3;
+    kl::print( "bounded: ", low_count / 1'000'000.0f, " of samples in the lower third" );
+
+    std::mt19937 twister{ 42 };
+    uint64_t checksum = 0;
+    float const twister_time = time_it( [&]
+    {
+        for ( int i = 0; i < sample_count; i++ )
+            checksum += twister() % 1000;
+    } );
+    float const gen_int_time = time_it( [&]
+    {
+        for ( int i = 0; i < sample_count; i++ )
+            checksum += kl::random::gen_int( 1000 );
+    } );
+    kl::PCG64 pcg{ 42, 7 };
+    float const pcg_time = time_it( [&]
+    {
+        for ( int i = 0; i < sample_count; i++ )
+            checksum += kl::random::gen_bounded( pcg, 1000 );
+    } );
+    kl::print( "ints: mt19937 ", sample_count / twister_time * 1e-6f, " M/s, gen_int ", sample_count / gen_int_time * 1e-6f,
+        " M/s, pcg64 ", sample_count / pcg_time * 1e-6f, " M/s (", checksum % 10, ")" );
+
+    std::vector<kl::Float2> points( 16'000'000 );
+    float const fill_time = time_it( [&]
+    {
+        kl::random::fill_float2( points, -1.0f, 1.0f );
+    } );
+    int const inside = (int) std::count_if( points.begin(), points.end(), []( kl::Float2 const& point )
+    {
+        return point.x * point.x + point.y * point.y <= 1.0f;
+    } );
+    kl::print( "floats: fill_float2 ", points.size() * 2 / fill_time * 1e-6f, " M/s, pi ~ ", 4.0f * inside / points.size() );
+
+    std::vector<byte> bytes( 64 * 1024 * 1024 );
+    float const bytes_time = time_it( [&]
+    {
+        kl::random::fill_bytes( bytes );
+    } );
+    kl::print( "bytes: fill_bytes ", bytes.size() / (1024.0f * 1024.0f) / bytes_time, " MB/s" );
+
+    bool const known = kl::Philox::block( { 0, 0 }, { 0, 0, 0, 0 } ) == std::array<uint32_t, 4>{ 0x6627E8D5, 0xE169C58D, 0xBC57AC4C, 0x9B00DBD8 }
+        && kl::Philox::block( { 0xA4093822, 0x299F31D0 }, { 0x243F6A88, 0x85A308D3, 0x13198A2E, 0x03707344 } ) == std::array<uint32_t, 4>{ 0xD16CFE09, 0x94FDCCEB, 0x5001E420, 0x24126EA1 };
+    kl::Philox philox{ 42, 3 };
+    std::vector<uint32_t> words( 1'000 );
+    philox.fill( words );
+    philox.seek( 100 );
+    uint64_t const draw = philox();
+    kl::print( "philox: known answers ", known ? "ok" : "broken", ", seek ", draw == (words[200] | (uint64_t( words[201] ) << 32)) ? "ok" : "broken" );
+
+    // Every path gets its own stream, so the result can't depend on scheduling or on the core count.
+    static constexpr int path_count = 100'000;
+    auto simulate = [&]( auto const& loop )
+    {
+        std::vector<float> results( path_count );
+        loop( 0, path_count, [&]( int path )
+        {
+            kl::Philox stream{ 2024, uint64_t( path ) };
+            float value = 1.0f;
+            for ( int step = 0; step < 100; step++ )
+                value *= 1.0f + 0.02f * (kl::random::to_float( uint32_t( stream() ) ) - 0.5f);
+            results[path] = value;
+        } );
+        return results;
+    };
+    std::vector<float> parallel;
+    float const parallel_time = time_it( [&]
+    {
+        parallel = simulate( []( int start, int end, auto const& body ) { kl::async_for( start, end, body ); } );
+    } );
+    std::vector<float> const serial = simulate( []( int start, int end, auto const& body ) { kl::sync_for( start, end, body ); } );
+    kl::print( "streams: async_for and sync_for ", memcmp( parallel.data(), serial.data(), parallel.size() * sizeof( float ) ) == 0 ? "identical" : "differ",
+        ", ", path_count * 100 / parallel_time * 1e-6f, " M/s" );
+
+    std::vector<float> floats( 64 * 1024 * 1024 );
+    float const philox_time = time_it( [&]
+    {
+        kl::Philox{ 7 }.fill_floats( floats );
+    } );
+    kl::print( "philox: fill_floats ", floats.size() / philox_time * 1e-6f, " M/s" );
+    return 0;
+}
@@ -0,0 +1,339 @@
+#include "klibrary.h"
+
+namespace js = kl::json;
+
+
+static std::atomic<uint64_t> allocation_count = 0;
+static std::atomic<uint64_t> allocated_bytes = 0;
+static std::atomic<int64_t> live_bytes = 0;
+static std::atomic<int64_t> peak_bytes = 0;
+
+// The suite is its own executable because it replaces global new, the header keeps the default new alignment.
+static constexpr size_t ALLOCATION_HEADER = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+void* operator new( size_t size )
+{
+    void* block = malloc( size + ALLOCATION_HEADER );
+    if ( !block )
+        throw std::bad_alloc();
+
+    *static_cast<size_t*>(block) = size;
+    allocation_count.fetch_add( 1, std::memory_order_relaxed );
+    allocated_bytes.fetch_add( size, std::memory_order_relaxed );
+    int64_t const live = live_bytes.fetch_add( size, std::memory_order_relaxed ) + size;
+    int64_t peak = peak_bytes.load( std::memory_order_relaxed );
+    while ( live > peak && !peak_bytes.compare_exchange_weak( peak, live, std::memory_order_relaxed ) );
+    return static_cast<byte*>(block) + ALLOCATION_HEADER;
+}
+
+void operator delete( void* pointer ) noexcept
+{
+    if ( !pointer )
+        return;
+
+    void* block = static_cast<byte*>(pointer) - ALLOCATION_HEADER;
+    live_bytes.fetch_sub( *static_cast<size_t*>(block), std::memory_order_relaxed );
+    free( block );
+}
+
+void operator delete( void* pointer, size_t size ) noexcept
+{
+    operator delete( pointer );
+}
+
+namespace
+{
+struct Corpus
+{
+    std::string name;
+    std::vector<std::string> documents;
+    size_t byte_size = 0;
+};
+
+struct PhaseResult
+{
+    float seconds = 0.0f;
+    uint64_t allocations = 0;
+    uint64_t allocated = 0;
+    int64_t peak = 0;
+};
+}
+
+static Corpus make_corpus( std::string_view const& name, std::vector<std::string>&& documents )
+{
+    Corpus corpus{ std::string{ name }, std::move( documents ) };
+    for ( auto& document : corpus.documents )
+        corpus.byte_size += document.size();
+    return corpus;
+}
+
+static std::string generate_twitter( int status_count )
+{
+    std::stringstream stream;
+    stream << std::setprecision( 17 );
+    stream << "{ \"statuses\": [";
+    for ( int i = 0; i < status_count; i++ )
+    {
+        uint64_t const id = 505874924095815681ull + i * 7919ull;
+        stream << "{ \"id\": " << id << ", \"id_str\": \"" << id << "\"";
+        stream << ", \"created_at\": \"Sun Aug 31 00:29:15 +0000 2014\"";
+        stream << ", \"text\": \"@aym0566x \\n\\u540d\\u524d:\\u524d\\u7530\\u3042\\u3086\\u307f status " << i << " \\ud83d\\ude00\"";
+        stream << ", \"user\": { \"id\": " << 1186275104 + i << ", \"name\": \"user " << i << "\", \"screen_name\": \"user_" << i << "\"";
+        stream << ", \"followers_count\": " << (i * 37) % 10007 << ", \"verified\": " << (i % 11 ? "false" : "true");
+        stream << ", \"profile_background_color\": \"C0DEED\", \"utc_offset\": null }";
+        stream << ", \"entities\": { \"hashtags\": [{ \"text\": \"tag" << i % 97 << "\", \"indices\": [" << i % 50 << ", " << i % 50 + 8 << "] }]";
+        stream << ", \"urls\": [], \"user_mentions\": [{ \"screen_name\": \"aym0566x\", \"id\": 866260188, \"indices\": [0, 9] }] }";
+        stream << ", \"retweet_count\": " << i % 13 << ", \"favorited\": false, \"lang\": \"ja\", \"coordinates\": null }";
+        if ( (i + 1) != status_count )
+            stream << ", ";
+    }
+    stream << "] }";
+    return stream.str();
+}
+
+static std::string generate_canada( int ring_count, int point_count )
+{
+    std::stringstream stream;
+    stream << std::setprecision( 17 );
+    stream << "{ \"type\": \"FeatureCollection\", \"features\": [{ \"type\": \"Feature\", \"properties\": { \"name\": \"Canada\" }";
+    stream << ", \"geometry\": { \"type\": \"Polygon\", \"coordinates\": [";
+    for ( int i = 0; i < ring_count; i++ )
+    {
+        stream << "[";
+        for ( int j = 0; j < point_count; j++ )
+        {
+            double const angle = j * (6.283185307179586 / point_count);
+            stream << "[" << -65.613616999999977 + i * 0.01 + std::cos( angle ) << ", " << 43.420273000000009 + std::sin( angle ) << "]";
+            if ( (j + 1) != point_count )
+                stream << ", ";
+        }
+        stream << "]";
+        if ( (i + 1) != ring_count )
+            stream << ", ";
+    }
+    stream << "] } }] }";
+    return stream.str();
+}
+
+static std::string generate_deep( int depth )
+{
+    std::string result;
+    for ( int i = 0; i < depth; i++ )
+        result += kl::format( "{ \"level\": ", i, ", \"name\": \"node\", \"children\": [true, null, " );
+    for ( int i = 0; i < depth; i++ )
+        result += "] }";
+    return result;
+}
+
+static std::vector<std::string> generate_small( int document_count )
+{
+    std::vector<std::string> result;
+    result.reserve( document_count );
+    for ( int i = 0; i < document_count; i++ )
+        result.push_back( kl::format( "{ \"id\": ", i, ", \"ok\": ", i % 2 ? "true" : "false", ", \"value\": ", i * 0.125, ", \"tag\": \"t", i % 10, "\" }" ) );
+    return result;
+}
+
+static std::string generate_huge_array( int element_count )
+{
+    std::stringstream stream;
+    stream << "[";
+    for ( int i = 0; i < element_count; i++ )
+    {
+        switch ( i % 4 )
+        {
+        case 0:
+            stream << i;
+            break;
+
+        case 1:
+            stream << i * 0.001;
+            break;
+
+        case 2:
+            stream << "\"item" << i << "\"";
+            break;
+
+        case 3:
+            stream << (i % 8 == 3 ? "true" : "null");
+            break;
+        }
+        if ( (i + 1) != element_count )
+            stream << ", ";
+    }
+    stream << "]";
+    return stream.str();
+}
+
+static void walk( js::Container const& container, double& number_sum, size_t& node_count )
+{
+    node_count += 1;
+    if ( js::Object const* object = dynamic_cast<js::Object const*>(&container) )
+    {
+        for ( auto& [key, value] : *object )
+            walk( *value, number_sum, node_count );
+    }
+    else if ( js::Array const* array = dynamic_cast<js::Array const*>(&container) )
+    {
+        for ( auto& value : *array )
+            walk( *value, number_sum, node_count );
+    }
+    else
+    {
+        number_sum += container.get_double().value_or( 0.0 );
+    }
+}
+
+// Keeps the fastest run, allocation counts are the same for every run.
+template<typename R, typename F>
+static PhaseResult measure( int repeat_count, R const& reset, F const& func )
+{
+    PhaseResult result{ std::numeric_limits<float>::infinity() };
+    for ( int i = 0; i < repeat_count; i++ )
+    {
+        reset();
+        uint64_t const first_count = allocation_count.load();
+        uint64_t const first_bytes = allocated_bytes.load();
+        int64_t const first_live = live_bytes.load();
+        peak_bytes.store( first_live );
+
+        auto start_time = kl::time::now();
+        func();
+        float const seconds = kl::time::elapsed( start_time );
+
+        result.seconds = std::min( result.seconds, seconds );
+        result.allocations = allocation_count.load() - first_count;
+        result.allocated = allocated_bytes.load() - first_bytes;
+        result.peak = peak_bytes.load() - first_live;
+    }
+    return result;
+}
+
+static void run_corpus( Corpus const& corpus, int repeat_count, js::Object& results )
+{
+    std::vector<kl::Ref<js::Container>> roots;
+    auto parse_corpus = [&]
+    {
+        for ( auto& document : corpus.documents )
+            roots.push_back( js::NdjsonReader::parse_line( document ) );
+    };
+    PhaseResult const parse = measure( repeat_count, [&]
+    {
+        roots.clear();
+        roots.reserve( corpus.documents.size() );
+    }, parse_corpus );
+
+    // Every access run starts from a freshly parsed tree, so work left over from parsing is always part of the access time.
+    double number_sum = 0.0;
+    size_t node_count = 0;
+    PhaseResult const access = measure( repeat_count, [&]
+    {
+        roots.clear();
+        parse_corpus();
+        number_sum = 0.0;
+        node_count = 0;
+    }, [&]
+    {
+        for ( auto& root : roots )
+            walk( *root, number_sum, node_count );
+    } );
+
+    size_t serialized_size = 0;
+    PhaseResult const serialize = measure( repeat_count, [&]
+    {
+        serialized_size = 0;
+    }, [&]
+    {
+        for ( auto& root : roots )
+            serialized_size += js::to_json( *root ).size();
+    } );
+
+    kl::Ref<js::Object> corpus_result = new js::Object( js::KeyOrder::INSERTION );
+    (*corpus_result)["bytes"] = js::make_number( corpus.byte_size );
+    (*corpus_result)["documents"] = js::make_number( corpus.documents.size() );
+    (*corpus_result)["nodes"] = js::make_number( node_count );
+
+    float const data_mb = corpus.byte_size / (1024.0f * 1024.0f);
+    kl::print( corpus.name, " (", corpus.documents.size(), " documents, ", data_mb, " MB, ", node_count, " nodes)" );
+    static constexpr std::string_view phase_names[] = { "parse", "access", "serialize" };
+    PhaseResult const* phases[] = { &parse, &access, &serialize };
+    for ( size_t i = 0; i < std::size( phases ); i++ )
+    {
+        PhaseResult const& phase = *phases[i];
+        kl::print( "  ", phase_names[i], ": ", phase.seconds, "s, ", data_mb / phase.seconds, " MB/s, ",
+            phase.allocations, " allocations, ", phase.allocated / (1024.0f * 1024.0f), " MB allocated, ",
+            phase.peak / (1024.0f * 1024.0f), " MB peak" );
+
+        kl::Ref<js::Object> phase_result = new js::Object( js::KeyOrder::INSERTION );
+        (*phase_result)["seconds"] = js::make_number( phase.seconds );
+        (*phase_result)["mb_per_second"] = js::make_number( data_mb / phase.seconds );
+        (*phase_result)["allocations"] = js::make_number( phase.allocations );
+        (*phase_result)["allocated_bytes"] = js::make_number( phase.allocated );
+        (*phase_result)["peak_bytes"] = js::make_number( phase.peak );
+        (*corpus_result)[phase_names[i]] = phase_result;
+    }
+    results[corpus.name] = corpus_result;
+}
+
+static std::optional<double> phase_seconds( js::Container const& corpus, std::string_view const& phase )
+{
+    js::Object const* object = dynamic_cast<js::Object const*>(&corpus);
+    if ( !object || !object->contains( phase ) )
+        return std::nullopt;
+
+    js::Object const* values = dynamic_cast<js::Object const*>(&object->at( phase ));
+    if ( !values || !values->contains( "seconds" ) )
+        return std::nullopt;
+    return values->at( "seconds" )->get_double();
+}
+
+static void compare_results( js::Object const& results, js::Object const& baseline )
+{
+    kl::print( "speedup against baseline:" );
+    for ( auto& [name, corpus] : results )
+    {
+        auto previous = baseline.find( name );
+        if ( previous == baseline.end() )
+            continue;
+
+        std::string line = kl::format( "  ", name, ":" );
+        for ( auto& phase : { "parse", "access", "serialize" } )
+        {
+            std::optional<double> const new_seconds = phase_seconds( *corpus, phase );
+            std::optional<double> const old_seconds = phase_seconds( *previous->second, phase );
+            if ( new_seconds > 0.0 && old_seconds )
+                line += kl::format( " ", phase, " ", old_seconds.value() / new_seconds.value(), "x" );
+        }
+        kl::print( line );
+    }
+}
+
+// Usage: json_suite [results.json] [baseline.json]
+int main( int argc, char** argv )
+{
+    std::string const output_path = argc > 1 ? argv[1] : "json_suite.json";
+    std::vector<Corpus> corpora;
+    corpora.push_back( make_corpus( "twitter", { generate_twitter( 20'000 ) } ) );
+    corpora.push_back( make_corpus( "canada", { generate_canada( 40, 5'000 ) } ) );
+    corpora.push_back( make_corpus( "deep", { generate_deep( 2'000 ) } ) );
+    corpora.push_back( make_corpus( "small", generate_small( 200'000 ) ) );
+    corpora.push_back( make_corpus( "huge_array", { generate_huge_array( 2'000'000 ) } ) );
+
+    js::Object results{ js::KeyOrder::INSERTION };
+    for ( auto& corpus : corpora )
+        run_corpus( corpus, 3, results );
+
+    if ( !kl::write_file( output_path, js::to_pretty_json( results ) ) )
+    {
+        kl::print( "Failed to write ", output_path );
+        return 1;
+    }
+    kl::print( "results written to ", output_path );
+
+    if ( argc > 2 )
+    {
+        js::Object const baseline{ kl::read_file( argv[2] ) };
+        compare_results( results, baseline );
+    }
+    return 0;
+}
@@ -4,9 +4,14 @@
 #include <any>
 #include <array>
 #include <atomic>
+#include <bit>
 #include <bitset>
+#include <charconv>
+#include <condition_variable>
+#include <coroutine>
 #include <cstdint>
 #include <ctime>
+#include <deque>
 #include <execution>
 #include <filesystem>
 #include <format>
@@ -19,6 +24,7 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <queue>
 #include <random>
 #include <ranges>
 #include <set>
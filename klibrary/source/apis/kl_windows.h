@@ -18,6 +18,7 @@
 #include <wininet.h>
 #include <dwmapi.h>
 #include <conio.h>
+#include <intrin.h>
 
 #pragma comment(lib, "ws2_32.lib")
 #pragma comment(lib, "mf.lib")
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "json/container/container.h"
+#include "json/language/number.h"
+#include "memory/files/file.h"
+
+
+namespace kl::json
+{
+struct MemoryReader
+{
+    byte const* data = nullptr;
+    uint64_t size = 0;
+    uint64_t position = 0;
+
+    bool read( void* output, uint64_t count )
+    {
+        if ( count > size - position )
+            return false;
+        memcpy( output, data + position, count );
+        position += count;
+        return true;
+    }
+};
+
+struct FileReader
+{
+    File const& file;
+
+    bool read( void* output, uint64_t count )
+    {
+        return file.read( static_cast<byte*>(output), count ) == count;
+    }
+};
+}
+
+namespace kl::json
+{
+inline void write_big_endian( std::vector<byte>& output, uint64_t value, int byte_count )
+{
+    for ( int i = byte_count - 1; i >= 0; i-- )
+        output.push_back( byte( value >> (i * 8) ) );
+}
+
+template<typename R>
+std::optional<uint64_t> read_big_endian( R& reader, int byte_count )
+{
+    byte buffer[8] = {};
+    if ( !reader.read( buffer, byte_count ) )
+        return std::nullopt;
+
+    uint64_t result = 0;
+    for ( int i = 0; i < byte_count; i++ )
+        result = (result << 8) | buffer[i];
+    return { result };
+}
+
+inline std::optional<int64_t> as_integer( double value )
+{
+    if ( value != std::trunc( value ) || value < -9223372036854775808.0 || value >= 9223372036854775808.0 )
+        return std::nullopt;
+    return { int64_t( value ) };
+}
+
+inline std::optional<int64_t> as_integer( Number const& value )
+{
+    switch ( value.type() )
+    {
+    case NumberType::INTEGER:
+        return { value.as<int64_t>() };
+
+    case NumberType::DOUBLE:
+        return as_integer( value.as<double>() );
+    }
+    return std::nullopt;
+}
+}
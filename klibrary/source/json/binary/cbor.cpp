@@ -0,0 +1,381 @@
+#include "klibrary.h"
+
+
+static constexpr int MAX_DEPTH = 512;
+
+static void write_head( std::vector<byte>& output, int major, uint64_t value )
+{
+    byte const type = byte( major << 5 );
+    if ( value < 24 )
+    {
+        output.push_back( type | byte( value ) );
+    }
+    else if ( value <= 0xFF )
+    {
+        output.push_back( type | 24 );
+        kl::json::write_big_endian( output, value, 1 );
+    }
+    else if ( value <= 0xFFFF )
+    {
+        output.push_back( type | 25 );
+        kl::json::write_big_endian( output, value, 2 );
+    }
+    else if ( value <= 0xFFFFFFFF )
+    {
+        output.push_back( type | 26 );
+        kl::json::write_big_endian( output, value, 4 );
+    }
+    else
+    {
+        output.push_back( type | 27 );
+        kl::json::write_big_endian( output, value, 8 );
+    }
+}
+
+void kl::json::Cbor::encode( Container const& container, std::vector<byte>& output )
+{
+    encode_value( container, output );
+}
+
+std::vector<byte> kl::json::Cbor::encode( Container const& container )
+{
+    std::vector<byte> output;
+    encode_value( container, output );
+    return output;
+}
+
+void kl::json::Cbor::encode_value( Container const& container, std::vector<byte>& output )
+{
+    if ( Literal const* literal = dynamic_cast<Literal const*>(&container) )
+    {
+        if ( bool const* value = std::get_if<bool>( &literal->m_value ) )
+        {
+            output.push_back( *value ? 0xF5 : 0xF4 );
+        }
+        else if ( Number const* value = literal->number() )
+        {
+            if ( value->type() == NumberType::UNSIGNED )
+            {
+                write_head( output, 0, value->as<uint64_t>() );
+            }
+            else if ( std::optional<int64_t> integer = as_integer( *value ) )
+            {
+                if ( integer.value() >= 0 )
+                {
+                    write_head( output, 0, uint64_t( integer.value() ) );
+                }
+                else
+                {
+                    write_head( output, 1, uint64_t( -(integer.value() + 1) ) );
+                }
+            }
+            else
+            {
+                output.push_back( 0xFB );
+                write_big_endian( output, std::bit_cast<uint64_t>(value->as<double>()), 8 );
+            }
+        }
+        else if ( std::string const* value = std::get_if<std::string>( &literal->m_value ) )
+        {
+            encode_string( *value, output );
+        }
+        else
+        {
+            output.push_back( 0xF6 );
+        }
+    }
+    else if ( Object const* object = dynamic_cast<Object const*>(&container) )
+    {
+        write_head( output, 5, object->size() );
+        for ( auto& [key, value] : *object )
+        {
+            encode_string( key, output );
+            encode_value( *value, output );
+        }
+    }
+    else if ( Array const* array = dynamic_cast<Array const*>(&container) )
+    {
+        write_head( output, 4, array->size() );
+        for ( auto& value : *array )
+            encode_value( *value, output );
+    }
+    else if ( auto value = container.get_bool() )
+    {
+        output.push_back( value.value() ? 0xF5 : 0xF4 );
+    }
+    else if ( auto value = container.get_double() )
+    {
+        Literal literal{};
+        literal.put_number( value.value() );
+        encode_value( literal, output );
+    }
+    else if ( auto value = container.get_string() )
+    {
+        encode_string( value.value(), output );
+    }
+    else
+    {
+        output.push_back( 0xF6 );
+    }
+}
+
+void kl::json::Cbor::encode_string( std::string_view const& value, std::vector<byte>& output )
+{
+    write_head( output, 3, value.size() );
+    output.insert( output.end(), value.begin(), value.end() );
+}
+
+namespace kl::json
+{
+template<typename R>
+static std::optional<uint64_t> read_argument( R& reader, byte info )
+{
+    if ( info < 24 )
+        return { info };
+    if ( info == 24 )
+        return read_big_endian( reader, 1 );
+    if ( info == 25 )
+        return read_big_endian( reader, 2 );
+    if ( info == 26 )
+        return read_big_endian( reader, 4 );
+    if ( info == 27 )
+        return read_big_endian( reader, 8 );
+    return std::nullopt;
+}
+
+template<typename R>
+static bool read_definite_text( R& reader, byte info, std::string& output )
+{
+    std::optional<uint64_t> size = read_argument( reader, info );
+    if ( !size )
+        return false;
+
+    size_t const first = output.size();
+    for ( uint64_t remaining = size.value(); remaining > 0; )
+    {
+        uint64_t const count = std::min<uint64_t>( remaining, 64 * 1024 );
+        output.resize( output.size() + count );
+        if ( !reader.read( output.data() + output.size() - count, count ) )
+        {
+            output.resize( first );
+            return false;
+        }
+        remaining -= count;
+    }
+    return true;
+}
+
+template<typename R>
+static bool read_text( R& reader, byte head, std::string& output )
+{
+    if ( (head & 31) != 31 )
+        return read_definite_text( reader, head & 31, output );
+
+    // Chunks of an indefinite string must be definite strings of the same major type, so they can't nest.
+    while ( true )
+    {
+        byte chunk = 0;
+        if ( !reader.read( &chunk, 1 ) )
+            return false;
+        if ( chunk == 0xFF )
+            return true;
+        if ( (chunk >> 5) != (head >> 5) || (chunk & 31) == 31 )
+            return false;
+        if ( !read_definite_text( reader, chunk & 31, output ) )
+            return false;
+    }
+}
+
+static double decode_half( uint16_t half )
+{
+    int const exponent = (half >> 10) & 0x1F;
+    int const mantissa = half & 0x3FF;
+    double value = 0.0;
+    if ( exponent == 0 )
+    {
+        value = std::ldexp( mantissa, -24 );
+    }
+    else if ( exponent != 31 )
+    {
+        value = std::ldexp( mantissa + 1024, exponent - 25 );
+    }
+    else
+    {
+        value = mantissa == 0 ? INFINITY : NAN;
+    }
+    return (half & 0x8000) ? -value : value;
+}
+
+template<typename R>
+static Ref<Container> decode_item( R& reader, byte head, int depth )
+{
+    if ( depth > MAX_DEPTH )
+        return {};
+
+    int const major = head >> 5;
+    byte const info = head & 31;
+    switch ( major )
+    {
+    case 0:
+    case 1:
+    {
+        std::optional<uint64_t> value = read_argument( reader, info );
+        if ( !value )
+            return {};
+        if ( major == 0 )
+            return make_number( value.value() );
+        if ( value.value() <= uint64_t( INT64_MAX ) )
+            return make_number( -1 - int64_t( value.value() ) );
+        return make_number( -1.0 - double( value.value() ) );
+    }
+
+    case 2:
+    case 3:
+    {
+        std::string text;
+        if ( !read_text( reader, head, text ) )
+            return {};
+        return make_string( text );
+    }
+
+    case 4:
+    {
+        std::optional<uint64_t> size = info == 31 ? std::optional<uint64_t>{ UINT64_MAX } : read_argument( reader, info );
+        if ( !size )
+            return {};
+
+        Ref array = new Array();
+        array->reserve( size_t( std::min<uint64_t>( size.value(), 1024 ) ) );
+        for ( uint64_t i = 0; i < size.value(); i++ )
+        {
+            byte item = 0;
+            if ( !reader.read( &item, 1 ) )
+                return {};
+            if ( info == 31 && item == 0xFF )
+                break;
+
+            Ref<Container> value = decode_item( reader, item, depth + 1 );
+            if ( !value )
+                return {};
+            array->push_back( std::move( value ) );
+        }
+        return array;
+    }
+
+    case 5:
+    {
+        std::optional<uint64_t> size = info == 31 ? std::optional<uint64_t>{ UINT64_MAX } : read_argument( reader, info );
+        if ( !size )
+            return {};
+
+        Ref object = new Object();
+        for ( uint64_t i = 0; i < size.value(); i++ )
+        {
+            byte item = 0;
+            if ( !reader.read( &item, 1 ) )
+                return {};
+            if ( info == 31 && item == 0xFF )
+                break;
+
+            Ref<Container> key = decode_item( reader, item, depth + 1 );
+            if ( !key || !reader.read( &item, 1 ) )
+                return {};
+            Ref<Container> value = decode_item( reader, item, depth + 1 );
+            if ( !value )
+                return {};
+
+            std::optional<std::string> name = key->get_string();
+            object->append( name ? std::move( name.value() ) : key->decompile( -1 ), std::move( value ) );
+        }
+        object->rebuild();
+        return object;
+    }
+
+    case 6:
+    {
+        byte item = 0;
+        if ( !read_argument( reader, info ) || !reader.read( &item, 1 ) )
+            return {};
+        return decode_item( reader, item, depth + 1 );
+    }
+    }
+
+    switch ( info )
+    {
+    case 20:
+        return make_bool( false );
+
+    case 21:
+        return make_bool( true );
+
+    case 25:
+    {
+        std::optional<uint64_t> bits = read_big_endian( reader, 2 );
+        if ( !bits )
+            return {};
+        return make_number( decode_half( uint16_t( bits.value() ) ) );
+    }
+
+    case 26:
+    {
+        std::optional<uint64_t> bits = read_big_endian( reader, 4 );
+        if ( !bits )
+            return {};
+        return make_number( std::bit_cast<float>(uint32_t( bits.value() )) );
+    }
+
+    case 27:
+    {
+        std::optional<uint64_t> bits = read_big_endian( reader, 8 );
+        if ( !bits )
+            return {};
+        return make_number( std::bit_cast<double>(bits.value()) );
+    }
+
+    case 24:
+    {
+        byte simple = 0;
+        if ( !reader.read( &simple, 1 ) )
+            return {};
+        return make_null();
+    }
+
+    case 31:
+        return {};
+    }
+    return make_null();
+}
+
+template<typename R>
+static Ref<Container> decode_cbor( R& reader )
+{
+    byte head = 0;
+    if ( !reader.read( &head, 1 ) )
+        return {};
+    return decode_item( reader, head, 0 );
+}
+}
+
+kl::Ref<kl::json::Container> kl::json::Cbor::decode( std::vector<byte> const& data )
+{
+    uint64_t position = 0;
+    return decode( data.data(), data.size(), position );
+}
+
+kl::Ref<kl::json::Container> kl::json::Cbor::decode( void const* data, uint64_t size, uint64_t& position )
+{
+    if ( position > size )
+        return {};
+
+    MemoryReader reader{ static_cast<byte const*>(data), size, position };
+    Ref<Container> result = decode_cbor( reader );
+    if ( result )
+        position = reader.position;
+    return result;
+}
+
+kl::Ref<kl::json::Container> kl::json::Cbor::decode( File const& file )
+{
+    FileReader reader{ file };
+    return decode_cbor( reader );
+}
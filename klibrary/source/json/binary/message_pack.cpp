@@ -0,0 +1,383 @@
+#include "klibrary.h"
+
+
+static constexpr int MAX_DEPTH = 512;
+
+static void write_size( std::vector<byte>& output, uint64_t size, byte fixed, uint64_t fixed_limit, byte first )
+{
+    if ( size < fixed_limit )
+    {
+        output.push_back( fixed | byte( size ) );
+    }
+    else if ( size <= 0xFFFF )
+    {
+        output.push_back( first );
+        kl::json::write_big_endian( output, size, 2 );
+    }
+    else
+    {
+        output.push_back( first + 1 );
+        kl::json::write_big_endian( output, size, 4 );
+    }
+}
+
+static void write_integer( std::vector<byte>& output, int64_t value )
+{
+    if ( value >= 0 )
+    {
+        if ( value < 0x80 )
+        {
+            output.push_back( byte( value ) );
+        }
+        else if ( value <= 0xFF )
+        {
+            output.push_back( 0xCC );
+            kl::json::write_big_endian( output, uint64_t( value ), 1 );
+        }
+        else if ( value <= 0xFFFF )
+        {
+            output.push_back( 0xCD );
+            kl::json::write_big_endian( output, uint64_t( value ), 2 );
+        }
+        else if ( value <= 0xFFFFFFFF )
+        {
+            output.push_back( 0xCE );
+            kl::json::write_big_endian( output, uint64_t( value ), 4 );
+        }
+        else
+        {
+            output.push_back( 0xCF );
+            kl::json::write_big_endian( output, uint64_t( value ), 8 );
+        }
+    }
+    else
+    {
+        if ( value >= -32 )
+        {
+            output.push_back( byte( value ) );
+        }
+        else if ( value >= INT8_MIN )
+        {
+            output.push_back( 0xD0 );
+            kl::json::write_big_endian( output, uint64_t( value ), 1 );
+        }
+        else if ( value >= INT16_MIN )
+        {
+            output.push_back( 0xD1 );
+            kl::json::write_big_endian( output, uint64_t( value ), 2 );
+        }
+        else if ( value >= INT32_MIN )
+        {
+            output.push_back( 0xD2 );
+            kl::json::write_big_endian( output, uint64_t( value ), 4 );
+        }
+        else
+        {
+            output.push_back( 0xD3 );
+            kl::json::write_big_endian( output, uint64_t( value ), 8 );
+        }
+    }
+}
+
+void kl::json::MessagePack::encode( Container const& container, std::vector<byte>& output )
+{
+    encode_value( container, output );
+}
+
+std::vector<byte> kl::json::MessagePack::encode( Container const& container )
+{
+    std::vector<byte> output;
+    encode_value( container, output );
+    return output;
+}
+
+void kl::json::MessagePack::encode_value( Container const& container, std::vector<byte>& output )
+{
+    if ( Literal const* literal = dynamic_cast<Literal const*>(&container) )
+    {
+        if ( bool const* value = std::get_if<bool>( &literal->m_value ) )
+        {
+            output.push_back( *value ? 0xC3 : 0xC2 );
+        }
+        else if ( Number const* value = literal->number() )
+        {
+            if ( value->type() == NumberType::UNSIGNED )
+            {
+                output.push_back( 0xCF );
+                write_big_endian( output, value->as<uint64_t>(), 8 );
+            }
+            else if ( std::optional<int64_t> integer = as_integer( *value ) )
+            {
+                write_integer( output, integer.value() );
+            }
+            else
+            {
+                output.push_back( 0xCB );
+                write_big_endian( output, std::bit_cast<uint64_t>(value->as<double>()), 8 );
+            }
+        }
+        else if ( std::string const* value = std::get_if<std::string>( &literal->m_value ) )
+        {
+            encode_string( *value, output );
+        }
+        else
+        {
+            output.push_back( 0xC0 );
+        }
+    }
+    else if ( Object const* object = dynamic_cast<Object const*>(&container) )
+    {
+        write_size( output, object->size(), 0x80, 16, 0xDE );
+        for ( auto& [key, value] : *object )
+        {
+            encode_string( key, output );
+            encode_value( *value, output );
+        }
+    }
+    else if ( Array const* array = dynamic_cast<Array const*>(&container) )
+    {
+        write_size( output, array->size(), 0x90, 16, 0xDC );
+        for ( auto& value : *array )
+            encode_value( *value, output );
+    }
+    else if ( auto value = container.get_bool() )
+    {
+        output.push_back( value.value() ? 0xC3 : 0xC2 );
+    }
+    else if ( auto value = container.get_double() )
+    {
+        Literal literal{};
+        literal.put_number( value.value() );
+        encode_value( literal, output );
+    }
+    else if ( auto value = container.get_string() )
+    {
+        encode_string( value.value(), output );
+    }
+    else
+    {
+        output.push_back( 0xC0 );
+    }
+}
+
+void kl::json::MessagePack::encode_string( std::string_view const& value, std::vector<byte>& output )
+{
+    if ( value.size() < 32 )
+    {
+        output.push_back( 0xA0 | byte( value.size() ) );
+    }
+    else if ( value.size() <= 0xFF )
+    {
+        output.push_back( 0xD9 );
+        write_big_endian( output, value.size(), 1 );
+    }
+    else
+    {
+        write_size( output, value.size(), 0xA0, 0, 0xDA );
+    }
+    output.insert( output.end(), value.begin(), value.end() );
+}
+
+namespace kl::json
+{
+template<typename R>
+static Ref<Container> read_text( R& reader, uint64_t size )
+{
+    std::string text;
+    for ( uint64_t remaining = size; remaining > 0; )
+    {
+        uint64_t const count = std::min<uint64_t>( remaining, 64 * 1024 );
+        text.resize( text.size() + count );
+        if ( !reader.read( text.data() + text.size() - count, count ) )
+            return {};
+        remaining -= count;
+    }
+    return make_string( text );
+}
+
+template<typename R>
+static Ref<Container> decode_value( R& reader, int depth );
+
+template<typename R>
+static Ref<Container> read_array( R& reader, uint64_t size, int depth )
+{
+    Ref array = new Array();
+    array->reserve( size_t( std::min<uint64_t>( size, 1024 ) ) );
+    for ( uint64_t i = 0; i < size; i++ )
+    {
+        Ref<Container> value = decode_value( reader, depth + 1 );
+        if ( !value )
+            return {};
+        array->push_back( std::move( value ) );
+    }
+    return array;
+}
+
+template<typename R>
+static Ref<Container> read_map( R& reader, uint64_t size, int depth )
+{
+    Ref object = new Object();
+    for ( uint64_t i = 0; i < size; i++ )
+    {
+        Ref<Container> key = decode_value( reader, depth + 1 );
+        if ( !key )
+            return {};
+        Ref<Container> value = decode_value( reader, depth + 1 );
+        if ( !value )
+            return {};
+
+        std::optional<std::string> name = key->get_string();
+        object->append( name ? std::move( name.value() ) : key->decompile( -1 ), std::move( value ) );
+    }
+    object->rebuild();
+    return object;
+}
+
+template<typename R>
+static Ref<Container> read_signed( R& reader, int byte_count )
+{
+    std::optional<uint64_t> bits = read_big_endian( reader, byte_count );
+    if ( !bits )
+        return {};
+
+    int const shift = 64 - byte_count * 8;
+    return make_number( int64_t( bits.value() << shift ) >> shift );
+}
+
+template<typename R>
+static Ref<Container> decode_value( R& reader, int depth )
+{
+    byte head = 0;
+    if ( depth > MAX_DEPTH || !reader.read( &head, 1 ) )
+        return {};
+
+    if ( head < 0x80 )
+        return make_number( head );
+    if ( head >= 0xE0 )
+        return make_number( int8_t( head ) );
+    if ( head < 0x90 )
+        return read_map( reader, head & 0x0F, depth );
+    if ( head < 0xA0 )
+        return read_array( reader, head & 0x0F, depth );
+    if ( head < 0xC0 )
+        return read_text( reader, head & 0x1F );
+
+    static constexpr int size_bytes[] = { 1, 2, 4 };
+    switch ( head )
+    {
+    case 0xC2:
+        return make_bool( false );
+
+    case 0xC3:
+        return make_bool( true );
+
+    case 0xC4:
+    case 0xC5:
+    case 0xC6:
+    case 0xD9:
+    case 0xDA:
+    case 0xDB:
+    {
+        std::optional<uint64_t> size = read_big_endian( reader, size_bytes[head >= 0xD9 ? (head - 0xD9) : (head - 0xC4)] );
+        if ( !size )
+            return {};
+        return read_text( reader, size.value() );
+    }
+
+    case 0xC7:
+    case 0xC8:
+    case 0xC9:
+    {
+        std::optional<uint64_t> size = read_big_endian( reader, size_bytes[head - 0xC7] );
+        if ( !size || !read_text( reader, size.value() + 1 ) )
+            return {};
+        return make_null();
+    }
+
+    case 0xCA:
+    {
+        std::optional<uint64_t> bits = read_big_endian( reader, 4 );
+        if ( !bits )
+            return {};
+        return make_number( std::bit_cast<float>(uint32_t( bits.value() )) );
+    }
+
+    case 0xCB:
+    {
+        std::optional<uint64_t> bits = read_big_endian( reader, 8 );
+        if ( !bits )
+            return {};
+        return make_number( std::bit_cast<double>(bits.value()) );
+    }
+
+    case 0xCC:
+    case 0xCD:
+    case 0xCE:
+    case 0xCF:
+    {
+        std::optional<uint64_t> value = read_big_endian( reader, 1 << (head - 0xCC) );
+        if ( !value )
+            return {};
+        return make_number( value.value() );
+    }
+
+    case 0xD0:
+    case 0xD1:
+    case 0xD2:
+    case 0xD3:
+        return read_signed( reader, 1 << (head - 0xD0) );
+
+    case 0xD4:
+    case 0xD5:
+    case 0xD6:
+    case 0xD7:
+    case 0xD8:
+        if ( !read_text( reader, (uint64_t( 1 ) << (head - 0xD4)) + 1 ) )
+            return {};
+        return make_null();
+
+    case 0xDC:
+    case 0xDD:
+    {
+        std::optional<uint64_t> size = read_big_endian( reader, head == 0xDC ? 2 : 4 );
+        if ( !size )
+            return {};
+        return read_array( reader, size.value(), depth );
+    }
+
+    case 0xDE:
+    case 0xDF:
+    {
+        std::optional<uint64_t> size = read_big_endian( reader, head == 0xDE ? 2 : 4 );
+        if ( !size )
+            return {};
+        return read_map( reader, size.value(), depth );
+    }
+    }
+    return make_null();
+}
+}
+
+kl::Ref<kl::json::Container> kl::json::MessagePack::decode( std::vector<byte> const& data )
+{
+    uint64_t position = 0;
+    return decode( data.data(), data.size(), position );
+}
+
+kl::Ref<kl::json::Container> kl::json::MessagePack::decode( void const* data, uint64_t size, uint64_t& position )
+{
+    if ( position > size )
+        return {};
+
+    MemoryReader reader{ static_cast<byte const*>(data), size, position };
+    Ref<Container> result = decode_value( reader, 0 );
+    if ( result )
+        position = reader.position;
+    return result;
+}
+
+kl::Ref<kl::json::Container> kl::json::MessagePack::decode( File const& file )
+{
+    FileReader reader{ file };
+    return decode_value( reader, 0 );
+}
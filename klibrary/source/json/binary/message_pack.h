@@ -0,0 +1,21 @@
+#pragma once
+
+#include "json/binary/binary_io.h"
+
+
+namespace kl::json
+{
+struct MessagePack
+{
+    static void encode( Container const& container, std::vector<byte>& output );
+    static std::vector<byte> encode( Container const& container );
+
+    static Ref<Container> decode( std::vector<byte> const& data );
+    static Ref<Container> decode( void const* data, uint64_t size, uint64_t& position );
+    static Ref<Container> decode( File const& file );
+
+private:
+    static void encode_value( Container const& container, std::vector<byte>& output );
+    static void encode_string( std::string_view const& value, std::vector<byte>& output );
+};
+}
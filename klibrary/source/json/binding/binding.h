@@ -0,0 +1,416 @@
+#pragma once
+
+#include "json/language/parser.h"
+#include "math/math.h"
+
+
+#define KL_JSON_FIELDS( TYPE, ... )                                                        \
+    static constexpr std::string_view kl_json_names = #__VA_ARGS__;                        \
+    auto kl_json_tie()                                                                     \
+    {                                                                                      \
+        static_assert(std::is_same_v<std::remove_cvref_t<decltype(*this)>, TYPE>);         \
+        return std::tie( __VA_ARGS__ );                                                    \
+    }                                                                                      \
+    auto kl_json_tie() const                                                               \
+    {                                                                                      \
+        return std::tie( __VA_ARGS__ );                                                    \
+    }
+
+
+namespace kl::json
+{
+template<typename T>
+concept JsonBound = requires( T& value ) { value.kl_json_tie(); };
+
+template<typename T>
+struct MathSize : std::integral_constant<int, 0> {};
+
+template<typename T>
+struct MathSize<Vector2<T>> : std::integral_constant<int, 2> {};
+
+template<typename T>
+struct MathSize<Vector3<T>> : std::integral_constant<int, 3> {};
+
+template<typename T>
+struct MathSize<Vector4<T>> : std::integral_constant<int, 4> {};
+
+template<typename T>
+struct MathSize<Quaternion_T<T>> : std::integral_constant<int, 4> {};
+
+template<typename T>
+struct MathSize<Matrix2x2<T>> : std::integral_constant<int, 4> {};
+
+template<typename T>
+struct MathSize<Matrix3x3<T>> : std::integral_constant<int, 9> {};
+
+template<typename T>
+struct MathSize<Matrix4x4<T>> : std::integral_constant<int, 16> {};
+
+template<typename T>
+struct IsOptional : std::false_type {};
+
+template<typename T>
+struct IsOptional<std::optional<T>> : std::true_type {};
+
+template<typename T>
+struct IsVector : std::false_type {};
+
+template<typename T, typename A>
+struct IsVector<std::vector<T, A>> : std::true_type {};
+}
+
+namespace kl::json
+{
+struct Binding
+{
+    template<typename T>
+    static bool read( std::string_view const& data, T& value )
+    {
+        Binding binding{ data };
+        size_t i = binding.skip_space( 0 );
+        return i < data.size() && binding.read_value( i, value );
+    }
+
+    template<typename T>
+    static void write( T const& value, std::string& output )
+    {
+        if constexpr ( IsOptional<T>::value )
+        {
+            if ( value )
+            {
+                write( *value, output );
+            }
+            else
+            {
+                output.append( Standard::null_val );
+            }
+        }
+        else if constexpr ( std::is_same_v<T, bool> )
+        {
+            output.append( value ? Standard::true_val : Standard::false_val );
+        }
+        else if constexpr ( std::is_integral_v<T> )
+        {
+            char digits[24] = {};
+            output.append( digits, std::to_chars( digits, digits + sizeof( digits ), value ).ptr );
+        }
+        else if constexpr ( std::is_floating_point_v<T> )
+        {
+            Lexer::encode_number( double( value ), output );
+        }
+        else if constexpr ( std::is_convertible_v<T const&, std::string_view> )
+        {
+            output.push_back( Standard::string );
+            Lexer::encode_string( value, output );
+            output.push_back( Standard::string );
+        }
+        else if constexpr ( IsVector<T>::value )
+        {
+            output.push_back( Standard::array_start );
+            for ( size_t i = 0; i < value.size(); i++ )
+            {
+                if ( i != 0 )
+                {
+                    output.push_back( Standard::splitter );
+                    output.push_back( ' ' );
+                }
+                write( value[i], output );
+            }
+            output.push_back( Standard::array_end );
+        }
+        else if constexpr ( MathSize<T>::value > 0 )
+        {
+            output.push_back( Standard::array_start );
+            for ( int i = 0; i < MathSize<T>::value; i++ )
+            {
+                if ( i != 0 )
+                {
+                    output.push_back( Standard::splitter );
+                    output.push_back( ' ' );
+                }
+                write( value[i], output );
+            }
+            output.push_back( Standard::array_end );
+        }
+        else
+        {
+            static_assert(JsonBound<T>, "type has no KL_JSON_FIELDS registration");
+            write_fields( value.kl_json_tie(), field_names<T>(), output, std::make_index_sequence<field_count<T>()>{} );
+        }
+    }
+
+private:
+    std::string_view data;
+    std::string scratch;
+    std::string key_scratch;
+
+    Binding( std::string_view const& data )
+        : data( data )
+    {}
+
+    template<typename T>
+    static constexpr size_t field_count()
+    {
+        return std::tuple_size_v<decltype(std::declval<T&>().kl_json_tie())>;
+    }
+
+    template<typename T>
+    static constexpr std::array<std::string_view, field_count<T>()> field_names()
+    {
+        std::array<std::string_view, field_count<T>()> result = {};
+        std::string_view names = T::kl_json_names;
+        for ( auto& name : result )
+        {
+            size_t const end = std::min( names.find( ',' ), names.size() );
+            name = names.substr( 0, end );
+            while ( !name.empty() && name.front() == ' ' )
+                name.remove_prefix( 1 );
+            while ( !name.empty() && name.back() == ' ' )
+                name.remove_suffix( 1 );
+            names.remove_prefix( std::min( end + 1, names.size() ) );
+        }
+        return result;
+    }
+
+    template<typename Tuple, size_t N, size_t... I>
+    static void write_fields( Tuple const& fields, std::array<std::string_view, N> const& names, std::string& output, std::index_sequence<I...> )
+    {
+        output.push_back( Standard::object_start );
+        if constexpr ( N > 0 )
+        {
+            output.push_back( ' ' );
+            ((write_field( std::get<I>( fields ), names[I], output, I + 1 == N )), ...);
+        }
+        output.push_back( Standard::object_end );
+    }
+
+    template<typename T>
+    static void write_field( T const& value, std::string_view const& name, std::string& output, bool last )
+    {
+        output.push_back( Standard::string );
+        output.append( name );
+        output.push_back( Standard::string );
+        output.push_back( Standard::assign );
+        output.push_back( ' ' );
+        write( value, output );
+        if ( !last )
+            output.push_back( Standard::splitter );
+        output.push_back( ' ' );
+    }
+
+    size_t skip_space( size_t i ) const
+    {
+        for ( ; i < data.size(); i++ )
+        {
+            switch ( data[i] )
+            {
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+            case Standard::splitter:
+            case Standard::assign:
+                continue;
+            }
+            break;
+        }
+        return i;
+    }
+
+    bool skip_value( size_t& i )
+    {
+        switch ( data[i] )
+        {
+        case Standard::object_start:
+        case Standard::array_start:
+            Parser::skip_container( data, i );
+            return i < data.size();
+
+        case Standard::string:
+            Parser::read_string( data, i, scratch );
+            return i < data.size();
+
+        case Standard::true_val.front():
+        case Standard::false_val.front():
+        case Standard::null_val.front():
+            Parser::read_keyword( data, i );
+            return true;
+
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            Parser::read_number( data, i );
+            return true;
+        }
+        return true;
+    }
+
+    template<typename T>
+    bool read_number( size_t& i, T& value )
+    {
+        std::string_view const number = Parser::read_number( data, i );
+        T result = {};
+        auto [last, error] = std::from_chars( number.data(), number.data() + number.size(), result );
+        if ( error == std::errc{} && last == number.data() + number.size() )
+        {
+            value = result;
+            return true;
+        }
+        if constexpr ( std::is_integral_v<T> )
+        {
+            double fallback = 0.0;
+            auto [fallback_last, fallback_error] = std::from_chars( number.data(), number.data() + number.size(), fallback );
+            if ( fallback_error != std::errc{} || fallback_last != number.data() + number.size() )
+                return false;
+
+            // Values like 1e3 still fit, anything outside of the integer range (or NaN) fails the binding.
+            double const limit = std::ldexp( 1.0, std::numeric_limits<T>::digits );
+            bool const in_range = std::is_signed_v<T> ? (fallback >= -limit && fallback < limit) : (fallback > -1.0 && fallback < limit);
+            if ( !in_range )
+                return false;
+            value = T( fallback );
+            return true;
+        }
+        return false;
+    }
+
+    template<typename T>
+    bool read_value( size_t& i, T& value )
+    {
+        char const c = data[i];
+        if constexpr ( IsOptional<T>::value )
+        {
+            if ( c == Standard::null_val.front() )
+            {
+                if ( Parser::read_keyword( data, i ) == TokenType::VAL_NULL )
+                    value.reset();
+                return true;
+            }
+            if ( !value )
+                value.emplace();
+            return read_value( i, *value );
+        }
+        else if constexpr ( std::is_same_v<T, bool> )
+        {
+            std::optional<TokenType> const type = Parser::read_keyword( data, i );
+            if ( type == TokenType::VAL_TRUE || type == TokenType::VAL_FALSE )
+            {
+                value = type == TokenType::VAL_TRUE;
+                return true;
+            }
+            return skip_value( i );
+        }
+        else if constexpr ( std::is_arithmetic_v<T> )
+        {
+            if ( c != '-' && (c < '0' || c > '9') )
+                return skip_value( i );
+            return read_number( i, value );
+        }
+        else if constexpr ( std::is_same_v<T, std::string> )
+        {
+            if ( c != Standard::string )
+                return skip_value( i );
+            value.assign( Parser::read_string( data, i, scratch ) );
+            return i < data.size();
+        }
+        else if constexpr ( IsVector<T>::value )
+        {
+            if ( c != Standard::array_start )
+                return skip_value( i );
+
+            value.clear();
+            for ( i = skip_space( i + 1 ); i < data.size(); i = skip_space( i + 1 ) )
+            {
+                if ( data[i] == Standard::array_end || data[i] == Standard::object_end )
+                    return true;
+                if ( !read_value( i, value.emplace_back() ) )
+                    return false;
+            }
+            return false;
+        }
+        else if constexpr ( MathSize<T>::value > 0 )
+        {
+            if ( c != Standard::array_start )
+                return skip_value( i );
+
+            int index = 0;
+            for ( i = skip_space( i + 1 ); i < data.size(); i = skip_space( i + 1 ) )
+            {
+                if ( data[i] == Standard::array_end || data[i] == Standard::object_end )
+                    return true;
+                bool const result = index < MathSize<T>::value ? read_value( i, value[index++] ) : skip_value( i );
+                if ( !result )
+                    return false;
+            }
+            return false;
+        }
+        else
+        {
+            static_assert(JsonBound<T>, "type has no KL_JSON_FIELDS registration");
+            if ( c != Standard::object_start )
+                return skip_value( i );
+
+            auto fields = value.kl_json_tie();
+            static constexpr auto names = field_names<T>();
+            for ( i = skip_space( i + 1 ); i < data.size(); i = skip_space( i + 1 ) )
+            {
+                if ( data[i] == Standard::object_end || data[i] == Standard::array_end )
+                    return true;
+                if ( data[i] != Standard::string )
+                {
+                    if ( !skip_value( i ) )
+                        return false;
+                    continue;
+                }
+
+                std::string_view const name = Parser::read_string( data, i, key_scratch );
+                i = skip_space( i + 1 );
+                if ( i >= data.size() )
+                    return false;
+                if ( !read_field( i, fields, names, name, std::make_index_sequence<field_count<T>()>{} ) )
+                    return false;
+            }
+            return false;
+        }
+    }
+
+    template<typename Tuple, size_t N, size_t... I>
+    bool read_field( size_t& i, Tuple& fields, std::array<std::string_view, N> const& names, std::string_view const& name, std::index_sequence<I...> )
+    {
+        bool result = true;
+        bool const found = ((names[I] == name && (result = read_value( i, std::get<I>( fields ) ), true)) || ...);
+        return found ? result : skip_value( i );
+    }
+};
+}
+
+namespace kl::json
+{
+template<JsonBound T>
+bool from_json( std::string_view const& data, T& value )
+{
+    return Binding::read( data, value );
+}
+
+template<JsonBound T>
+void to_json( T const& value, std::string& output )
+{
+    Binding::write( value, output );
+}
+
+template<JsonBound T>
+std::string to_json( T const& value )
+{
+    std::string result;
+    Binding::write( value, result );
+    return result;
+}
+}
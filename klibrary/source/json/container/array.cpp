@@ -6,8 +6,7 @@ kl::json::Array::Array()
 
 kl::json::Array::Array( std::string_view const& data )
 {
-    auto tokens = Lexer::parse( data );
-    compile( tokens.begin(), tokens.end() );
+    Parser::parse( data, *this );
 }
 
 bool kl::json::Array::compile( std::vector<Token>::const_iterator first, std::vector<Token>::const_iterator last )
@@ -51,17 +50,7 @@ bool kl::json::Array::compile( std::vector<Token>::const_iterator first, std::ve
 
 std::string kl::json::Array::decompile( int depth ) const
 {
-    if ( empty() )
-        return format( Standard::array_start, Standard::array_end );
-
-    std::stringstream stream;
-    stream << Standard::array_start;
-    for ( size_t i = 0; i < size(); i++ )
-    {
-        stream << (*this)[i]->decompile( -1 );
-        if ( (i + 1) != size() )
-            stream << Standard::splitter << ' ';
-    }
-    stream << Standard::array_end;
-    return stream.str();
+    std::string result;
+    Serializer<true>{ result }.write( *this, depth );
+    return result;
 }
@@ -0,0 +1,293 @@
+#include "klibrary.h"
+
+
+size_t kl::json::Column::size() const
+{
+    return present.size();
+}
+
+std::string_view kl::json::Column::get_string( size_t row ) const
+{
+    if ( type != ColumnType::STRING || (row + 1) >= offsets.size() )
+        return {};
+    return std::string_view{ text }.substr( offsets[row], offsets[row + 1] - offsets[row] );
+}
+
+kl::json::ColumnArray::ColumnArray( std::vector<ColumnSpec> const& spec )
+    : m_fields( spec.size() )
+{
+    for ( auto& [name, type] : spec )
+    {
+        Column& column = m_columns.emplace_back();
+        column.name = name;
+        column.type = type;
+    }
+    clear();
+}
+
+bool kl::json::ColumnArray::decode( std::string_view const& data )
+{
+    clear();
+    size_t i = skip_space( data, 0 );
+    if ( i >= data.size() || data[i] != Standard::array_start )
+    {
+        m_errors.push_back( { 0, i, "Input is not an array." } );
+        return false;
+    }
+
+    uint64_t row = 0;
+    std::string error;
+    for ( i = skip_space( data, i + 1 ); i < data.size(); i = skip_space( data, i + 1 ) )
+    {
+        if ( data[i] == Standard::array_end )
+            return true;
+
+        size_t const first = i;
+        if ( !read_row( data, i, error ) )
+        {
+            m_errors.push_back( { row, first, error } );
+            i = first;
+            skip_value( data, i );
+        }
+        row += 1;
+    }
+    m_errors.push_back( { row, data.size(), "Array is not terminated." } );
+    return false;
+}
+
+void kl::json::ColumnArray::clear()
+{
+    for ( auto& column : m_columns )
+    {
+        column.doubles.clear();
+        column.longs.clear();
+        column.bools.clear();
+        column.offsets.clear();
+        column.text.clear();
+        column.present.clear();
+        if ( column.type == ColumnType::STRING )
+            column.offsets.push_back( 0 );
+    }
+    m_errors.clear();
+    m_row_count = 0;
+}
+
+size_t kl::json::ColumnArray::row_count() const
+{
+    return m_row_count;
+}
+
+std::vector<kl::json::Column> const& kl::json::ColumnArray::columns() const
+{
+    return m_columns;
+}
+
+kl::json::Column const* kl::json::ColumnArray::column( std::string_view const& name ) const
+{
+    for ( auto& column : m_columns )
+    {
+        if ( column.name == name )
+            return &column;
+    }
+    return nullptr;
+}
+
+std::vector<kl::json::ColumnError> const& kl::json::ColumnArray::errors() const
+{
+    return m_errors;
+}
+
+size_t kl::json::ColumnArray::skip_space( std::string_view const& data, size_t i )
+{
+    for ( ; i < data.size(); i++ )
+    {
+        switch ( data[i] )
+        {
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+        case Standard::splitter:
+        case Standard::assign:
+            continue;
+        }
+        break;
+    }
+    return i;
+}
+
+void kl::json::ColumnArray::skip_value( std::string_view const& data, size_t& i )
+{
+    switch ( data[i] )
+    {
+    case Standard::object_start:
+    case Standard::array_start:
+        Parser::skip_container( data, i );
+        break;
+
+    case Standard::string:
+        Parser::read_string( data, i, m_scratch );
+        break;
+
+    case Standard::true_val.front():
+    case Standard::false_val.front():
+    case Standard::null_val.front():
+        Parser::read_keyword( data, i );
+        break;
+
+    default:
+    {
+        size_t const first = i;
+        if ( Parser::read_number( data, i ).empty() )
+            i = first;
+        break;
+    }
+    }
+}
+
+bool kl::json::ColumnArray::read_row( std::string_view const& data, size_t& i, std::string& error )
+{
+    if ( data[i] != Standard::object_start )
+    {
+        error = "Row is not an object.";
+        return false;
+    }
+
+    for ( auto& field : m_fields )
+        field.present = false;
+
+    for ( i = skip_space( data, i + 1 ); i < data.size(); i = skip_space( data, i + 1 ) )
+    {
+        if ( data[i] == Standard::object_end )
+        {
+            commit_row();
+            return true;
+        }
+        if ( data[i] != Standard::string )
+        {
+            error = "Row has a value without a key.";
+            return false;
+        }
+
+        std::string_view const key = Parser::read_string( data, i, m_scratch );
+        i = skip_space( data, i + 1 );
+        if ( i >= data.size() )
+            break;
+
+        size_t index = 0;
+        while ( index < m_columns.size() && m_columns[index].name != key )
+            index += 1;
+        if ( index == m_columns.size() )
+        {
+            skip_value( data, i );
+            continue;
+        }
+        if ( !read_field( data, i, index, error ) )
+            return false;
+    }
+    error = "Row is not terminated.";
+    return false;
+}
+
+bool kl::json::ColumnArray::read_field( std::string_view const& data, size_t& i, size_t index, std::string& error )
+{
+    Column const& column = m_columns[index];
+    Field& field = m_fields[index];
+    char const c = data[i];
+    if ( c == Standard::null_val.front() && Parser::read_keyword( data, i ) == TokenType::VAL_NULL )
+    {
+        field.present = false;
+        return true;
+    }
+
+    switch ( column.type )
+    {
+    case ColumnType::DOUBLE:
+    case ColumnType::LONG:
+    {
+        if ( c != '-' && (c < '0' || c > '9') )
+            break;
+
+        std::optional<Number> const number = Number::parse( Parser::read_number( data, i ) );
+        if ( !number )
+        {
+            error = format( "Column ", column.name, " has an invalid number." );
+            return false;
+        }
+        if ( column.type == ColumnType::DOUBLE )
+        {
+            field.number = number->as<double>();
+        }
+        else if ( std::optional<int64_t> integer = as_integer( number.value() ) )
+        {
+            field.integer = integer.value();
+        }
+        else
+        {
+            error = format( "Column ", column.name, " expects an integer." );
+            return false;
+        }
+        field.present = true;
+        return true;
+    }
+
+    case ColumnType::BOOL:
+    {
+        std::optional<TokenType> const type = Parser::read_keyword( data, i );
+        if ( type != TokenType::VAL_TRUE && type != TokenType::VAL_FALSE )
+            break;
+
+        field.boolean = type == TokenType::VAL_TRUE;
+        field.present = true;
+        return true;
+    }
+
+    case ColumnType::STRING:
+    {
+        if ( c != Standard::string )
+            break;
+
+        field.text = Parser::read_string( data, i, field.scratch );
+        if ( i >= data.size() )
+        {
+            error = format( "Column ", column.name, " has an unterminated string." );
+            return false;
+        }
+        field.present = true;
+        return true;
+    }
+    }
+    error = format( "Column ", column.name, " has a value of the wrong type." );
+    return false;
+}
+
+void kl::json::ColumnArray::commit_row()
+{
+    for ( size_t i = 0; i < m_columns.size(); i++ )
+    {
+        Column& column = m_columns[i];
+        Field const& field = m_fields[i];
+        column.present.push_back( field.present );
+        switch ( column.type )
+        {
+        case ColumnType::DOUBLE:
+            column.doubles.push_back( field.present ? field.number : 0.0 );
+            break;
+
+        case ColumnType::LONG:
+            column.longs.push_back( field.present ? field.integer : 0 );
+            break;
+
+        case ColumnType::BOOL:
+            column.bools.push_back( field.present && field.boolean );
+            break;
+
+        case ColumnType::STRING:
+            if ( field.present )
+                column.text.append( field.text );
+            column.offsets.push_back( column.text.size() );
+            break;
+        }
+    }
+    m_row_count += 1;
+}
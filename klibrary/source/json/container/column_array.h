@@ -0,0 +1,94 @@
+#pragma once
+
+#include "json/language/parser.h"
+
+
+namespace kl::json
+{
+enum struct ColumnType : int32_t
+{
+    DOUBLE = 0,
+    LONG,
+    BOOL,
+    STRING,
+};
+}
+
+namespace kl::json
+{
+struct ColumnSpec
+{
+    std::string name;
+    ColumnType type = ColumnType::DOUBLE;
+};
+
+struct ColumnError
+{
+    uint64_t row = 0;
+    uint64_t offset = 0;
+    std::string message;
+};
+}
+
+namespace kl::json
+{
+// Only the vector matching the column type is filled. Missing and null fields
+// get a default value and a zero in the present mask.
+struct Column
+{
+    std::string name;
+    ColumnType type = ColumnType::DOUBLE;
+
+    std::vector<double> doubles;
+    std::vector<int64_t> longs;
+    std::vector<uint8_t> bools;
+    std::vector<uint64_t> offsets;
+    std::string text;
+    std::vector<uint8_t> present;
+
+    size_t size() const;
+    std::string_view get_string( size_t row ) const;
+};
+}
+
+namespace kl::json
+{
+// Rows that are not objects or hold a value of the wrong type are left out
+// of the columns and reported in errors(), decoding continues with the next row.
+struct ColumnArray : NoCopy
+{
+    ColumnArray( std::vector<ColumnSpec> const& spec );
+
+    bool decode( std::string_view const& data );
+    void clear();
+
+    size_t row_count() const;
+    std::vector<Column> const& columns() const;
+    Column const* column( std::string_view const& name ) const;
+    std::vector<ColumnError> const& errors() const;
+
+private:
+    struct Field
+    {
+        bool present = false;
+        double number = 0.0;
+        int64_t integer = 0;
+        bool boolean = false;
+        std::string_view text;
+        std::string scratch;
+    };
+
+    std::vector<Column> m_columns;
+    std::vector<Field> m_fields;
+    std::vector<ColumnError> m_errors;
+    std::string m_scratch;
+    size_t m_row_count = 0;
+
+    static size_t skip_space( std::string_view const& data, size_t i );
+    void skip_value( std::string_view const& data, size_t& i );
+
+    bool read_row( std::string_view const& data, size_t& i, std::string& error );
+    bool read_field( std::string_view const& data, size_t& i, size_t index, std::string& error );
+    void commit_row();
+};
+}
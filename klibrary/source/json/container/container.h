@@ -33,6 +33,5 @@ struct Container
 
 namespace kl::json
 {
-using ObjectStorage = std::map<std::string, Ref<Container>, std::less<>>;
 using ArrayStorage = std::vector<Ref<Container>>;
 }
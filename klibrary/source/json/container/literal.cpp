@@ -6,8 +6,7 @@ kl::json::Literal::Literal()
 
 kl::json::Literal::Literal( std::string_view const& data )
 {
-    auto tokens = Lexer::parse( data );
-    compile( tokens.begin(), tokens.end() );
+    Parser::parse( data, *this );
 }
 
 bool kl::json::Literal::compile( std::vector<Token>::const_iterator first, std::vector<Token>::const_iterator last )
@@ -30,12 +29,7 @@ bool kl::json::Literal::compile( std::vector<Token>::const_iterator first, std::
         return true;
 
     case TokenType::LIT_NUMBER:
-        if ( auto opt = parse_float( first->value ) )
-        {
-            put_number( opt.value() );
-            return true;
-        }
-        break;
+        return parse_number( first->value );
 
     case TokenType::LIT_STRING:
         put_string( first->value );
@@ -46,24 +40,9 @@ bool kl::json::Literal::compile( std::vector<Token>::const_iterator first, std::
 
 std::string kl::json::Literal::decompile( int depth ) const
 {
-    if ( auto opt = get_bool() )
-        return std::string{ opt.value() ? Standard::true_val : Standard::false_val };
-    if ( auto opt = get_double() )
-    {
-        double flt_value = opt.value();
-        int64_t int_value = (int64_t) flt_value;
-        if ( int_value == flt_value )
-        {
-            return std::to_string( int_value );
-        }
-        return format( flt_value );
-    }
-    if ( auto opt = get_string() )
-    {
-        Lexer::from_escaping( opt.value() );
-        return format( Standard::string, opt.value(), Standard::string );
-    }
-    return std::string{ Standard::null_val };
+    std::string result;
+    Serializer<true>{ result }.write( *this, depth );
+    return result;
 }
 
 void kl::json::Literal::put_null()
@@ -83,46 +62,73 @@ std::optional<bool> kl::json::Literal::get_bool() const
 
 void kl::json::Literal::put_number( double value )
 {
-    m_value.emplace<double>( value );
+    m_value.emplace<Number>( value );
+}
+
+void kl::json::Literal::put_number( Number const& value )
+{
+    m_value.emplace<Number>( value );
+}
+
+bool kl::json::Literal::parse_number( std::string_view const& text )
+{
+    if ( !Number::is_integer_text( text ) && !Number::validate( text ) )
+        return false;
+
+    std::optional<Number> number = Number::parse( text );
+    if ( !number )
+        return false;
+
+    m_value.emplace<Number>( number.value() );
+    return true;
+}
+
+std::optional<kl::json::Number> kl::json::Literal::get_number() const
+{
+    if ( Number const* value = number() )
+        return { *value };
+    return std::nullopt;
 }
 
 std::optional<double> kl::json::Literal::get_double() const
 {
-    return try_get<double>();
+    if ( Number const* value = number() )
+        return value->as<double>();
+    return std::nullopt;
 }
 
 std::optional<float> kl::json::Literal::get_float() const
 {
-    if ( auto opt = get_double() )
-        return float( opt.value() );
+    if ( Number const* value = number() )
+        return value->as<float>();
     return std::nullopt;
 }
 
 std::optional<int64_t> kl::json::Literal::get_long() const
 {
-    if ( auto opt = get_double() )
-        return int64_t( opt.value() );
+    if ( Number const* value = number() )
+        return value->as<int64_t>();
     return std::nullopt;
 }
 
 std::optional<int32_t> kl::json::Literal::get_int() const
 {
-    if ( auto opt = get_double() )
-        return int32_t( opt.value() );
+    if ( Number const* value = number() )
+        return value->as<int32_t>();
     return std::nullopt;
 }
 
 std::optional<int16_t> kl::json::Literal::get_short() const
 {
-    if ( auto opt = get_double() )
-        return int16_t( opt.value() );
+    if ( Number const* value = number() )
+        return value->as<int16_t>();
     return std::nullopt;
 }
 
 std::optional<uint8_t> kl::json::Literal::get_byte() const
 {
-    if ( auto opt = get_double() )
-        return uint8_t( opt.value() );
+    if ( Number const* value = number() )
+        return value->as<uint8_t>();
     return std::nullopt;
 }
 
@@ -135,3 +141,8 @@ std::optional<std::string> kl::json::Literal::get_string() const
 {
     return try_get<std::string>();
 }
+
+kl::json::Number const* kl::json::Literal::number() const
+{
+    return std::get_if<Number>( &m_value );
+}
@@ -1,12 +1,27 @@
 #pragma once
 
 #include "json/container/container.h"
+#include "json/language/number.h"
 
 
+namespace kl::json
+{
+template<bool Pretty>
+struct Serializer;
+
+struct Cbor;
+struct MessagePack;
+}
+
 namespace kl::json
 {
 struct Literal : Container
 {
+    template<bool Pretty>
+    friend struct Serializer;
+    friend struct Cbor;
+    friend struct MessagePack;
+
     Literal();
     Literal( std::string_view const& data );
 
@@ -19,6 +34,9 @@ struct Literal : Container
     std::optional<bool> get_bool() const override;
 
     void put_number( double value ) override;
+    void put_number( Number const& value );
+    bool parse_number( std::string_view const& text );
+    std::optional<Number> get_number() const;
     std::optional<double> get_double() const override;
     std::optional<float> get_float() const override;
     std::optional<int64_t> get_long() const override;
@@ -30,7 +48,9 @@ struct Literal : Container
     std::optional<std::string> get_string() const override;
 
 private:
-    std::variant<std::nullptr_t, bool, double, std::string> m_value;
+    std::variant<std::nullptr_t, bool, Number, std::string> m_value;
+
+    Number const* number() const;
 
     template<typename T>
     std::optional<T> try_get() const
@@ -60,7 +80,7 @@ inline Ref<Literal> make_bool( bool value )
     return result;
 }
 
-inline Ref<Literal> make_number( double value )
+inline Ref<Literal> make_number( Number const& value )
 {
     Ref result = new Literal();
     result->put_number( value );
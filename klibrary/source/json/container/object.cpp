@@ -4,10 +4,14 @@
 kl::json::Object::Object()
 {}
 
-kl::json::Object::Object( std::string_view const& data )
+kl::json::Object::Object( KeyOrder order )
+    : ObjectStorage( order )
+{}
+
+kl::json::Object::Object( std::string_view const& data, KeyOrder order )
+    : ObjectStorage( order )
 {
-    auto tokens = Lexer::parse( data );
-    compile( tokens.begin(), tokens.end() );
+    Parser::parse( data, *this );
 }
 
 bool kl::json::Object::compile( std::vector<Token>::const_iterator first, std::vector<Token>::const_iterator last )
@@ -30,7 +34,7 @@ bool kl::json::Object::compile( std::vector<Token>::const_iterator first, std::v
                 }
                 else if ( it->type == TokenType::OBJECT_START )
                 {
-                    container = new Object();
+                    container = new Object( order() );
                 }
                 else
                 {
@@ -60,44 +64,7 @@ bool kl::json::Object::compile( std::vector<Token>::const_iterator first, std::v
 
 std::string kl::json::Object::decompile( int depth ) const
 {
-    if ( empty() )
-        return format( Standard::object_start, Standard::object_end );
-
-    size_t counter = 0;
-    std::stringstream stream;
-    if ( depth >= 0 )
-    {
-        std::string map_depth( depth * 2, ' ' );
-        std::string content_depth( (depth + 1) * 2, ' ' );
-        stream << Standard::object_start << '\n';
-        for ( auto& [key, value] : *this )
-        {
-            std::string name = key;
-            Lexer::from_escaping( name );
-            stream << content_depth << Standard::string << name << Standard::string;
-            stream << Standard::assign << ' ';
-            stream << value->decompile( depth + 1 );
-            if ( ++counter != size() )
-                stream << Standard::splitter;
-            stream << '\n';
-        }
-        stream << map_depth << Standard::object_end;
-    }
-    else
-    {
-        stream << Standard::object_start << ' ';
-        for ( auto& [key, value] : *this )
-        {
-            std::string name = key;
-            Lexer::from_escaping( name );
-            stream << Standard::string << name << Standard::string;
-            stream << Standard::assign << ' ';
-            stream << value->decompile( -1 );
-            if ( ++counter != size() )
-                stream << Standard::splitter;
-            stream << ' ';
-        }
-        stream << Standard::object_end;
-    }
-    return stream.str();
+    std::string result;
+    Serializer<true>{ result }.write( *this, depth );
+    return result;
 }
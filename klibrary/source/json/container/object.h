@@ -1,6 +1,6 @@
 #pragma once
 
-#include "json/container/container.h"
+#include "json/container/object_storage.h"
 
 
 namespace kl::json
@@ -8,7 +8,8 @@ namespace kl::json
 struct Object : ObjectStorage, Container
 {
     Object();
-    Object( std::string_view const& data );
+    explicit Object( KeyOrder order );
+    Object( std::string_view const& data, KeyOrder order = KeyOrder::SORTED );
 
     bool compile( std::vector<Token>::const_iterator first, std::vector<Token>::const_iterator last ) override;
     std::string decompile( int depth = 0 ) const override;
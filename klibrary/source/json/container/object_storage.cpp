@@ -0,0 +1,313 @@
+#include "klibrary.h"
+
+
+kl::json::ObjectKey::ObjectKey()
+{}
+
+kl::json::ObjectKey::operator std::string_view() const
+{
+    if ( !m_value )
+        return {};
+    return *m_value;
+}
+
+kl::json::ObjectKey::operator std::string const&() const
+{
+    static std::string const empty;
+    if ( !m_value )
+        return empty;
+    return *m_value;
+}
+
+bool kl::json::ObjectKey::operator==( ObjectKey const& other ) const
+{
+    return m_value == other.m_value || std::string_view{ *this } == std::string_view{ other };
+}
+
+bool kl::json::ObjectKey::operator<( ObjectKey const& other ) const
+{
+    return std::string_view{ *this } < std::string_view{ other };
+}
+
+kl::json::ObjectKey kl::json::KeyTable::intern( std::string_view const& key )
+{
+    auto it = m_keys.find( key );
+    if ( it != m_keys.end() )
+        return it->second;
+
+    ObjectKey result{ key };
+    m_keys.emplace( std::string_view{ result }, result );
+    return result;
+}
+
+void kl::json::KeyTable::clear()
+{
+    m_keys.clear();
+}
+
+kl::json::ObjectStorage::ObjectStorage( KeyOrder order )
+    : m_order( order )
+{}
+
+kl::json::ObjectStorage::ObjectStorage( ObjectStorage const& other )
+{
+    *this = other;
+}
+
+kl::json::ObjectStorage::ObjectStorage( ObjectStorage&& other ) noexcept
+{
+    *this = std::move( other );
+}
+
+kl::json::ObjectStorage& kl::json::ObjectStorage::operator=( ObjectStorage const& other )
+{
+    if ( this == &other )
+        return *this;
+
+    other.sort_entries();
+    m_order = other.m_order;
+    m_entries = other.m_entries;
+    m_index = other.m_index;
+    m_unsorted = false;
+    return *this;
+}
+
+kl::json::ObjectStorage& kl::json::ObjectStorage::operator=( ObjectStorage&& other ) noexcept
+{
+    if ( this == &other )
+        return *this;
+
+    m_order = other.m_order;
+    m_entries = std::move( other.m_entries );
+    m_index = std::move( other.m_index );
+    m_unsorted = other.m_unsorted.exchange( false );
+    other.m_entries.clear();
+    other.m_index.clear();
+    return *this;
+}
+
+kl::json::KeyOrder kl::json::ObjectStorage::order() const
+{
+    return m_order;
+}
+
+size_t kl::json::ObjectStorage::size() const
+{
+    return m_entries.size();
+}
+
+bool kl::json::ObjectStorage::empty() const
+{
+    return m_entries.empty();
+}
+
+void kl::json::ObjectStorage::reserve( size_t capacity )
+{
+    m_entries.reserve( capacity );
+}
+
+void kl::json::ObjectStorage::clear()
+{
+    m_entries.clear();
+    m_index.clear();
+    m_unsorted = false;
+}
+
+kl::json::ObjectStorage::iterator kl::json::ObjectStorage::begin()
+{
+    sort_entries();
+    return m_entries.begin();
+}
+
+kl::json::ObjectStorage::iterator kl::json::ObjectStorage::end()
+{
+    sort_entries();
+    return m_entries.end();
+}
+
+kl::json::ObjectStorage::const_iterator kl::json::ObjectStorage::begin() const
+{
+    sort_entries();
+    return m_entries.begin();
+}
+
+kl::json::ObjectStorage::const_iterator kl::json::ObjectStorage::end() const
+{
+    sort_entries();
+    return m_entries.end();
+}
+
+kl::json::ObjectStorage::iterator kl::json::ObjectStorage::find( std::string_view const& key )
+{
+    return m_entries.begin() + find_position( key, m_entries.size() );
+}
+
+kl::json::ObjectStorage::const_iterator kl::json::ObjectStorage::find( std::string_view const& key ) const
+{
+    return m_entries.begin() + find_position( key, m_entries.size() );
+}
+
+bool kl::json::ObjectStorage::contains( std::string_view const& key ) const
+{
+    return find_position( key, m_entries.size() ) < m_entries.size();
+}
+
+kl::Ref<kl::json::Container>& kl::json::ObjectStorage::at( std::string_view const& key )
+{
+    size_t const position = find_position( key, m_entries.size() );
+    if ( position >= m_entries.size() )
+        throw std::out_of_range( "Json object does not contain the requested key." );
+    return m_entries[position].second;
+}
+
+kl::Ref<kl::json::Container> const& kl::json::ObjectStorage::at( std::string_view const& key ) const
+{
+    size_t const position = find_position( key, m_entries.size() );
+    if ( position >= m_entries.size() )
+        throw std::out_of_range( "Json object does not contain the requested key." );
+    return m_entries[position].second;
+}
+
+kl::Ref<kl::json::Container>& kl::json::ObjectStorage::operator[]( std::string_view const& key )
+{
+    size_t const position = find_position( key, m_entries.size() );
+    if ( position < m_entries.size() )
+        return m_entries[position].second;
+    return insert_new( ObjectKey{ key }, {} )->second;
+}
+
+std::pair<kl::json::ObjectStorage::iterator, bool> kl::json::ObjectStorage::insert_or_assign( ObjectKey const& key, Ref<Container> const& value )
+{
+    size_t const position = find_position( key, m_entries.size() );
+    if ( position < m_entries.size() )
+    {
+        m_entries[position].second = value;
+        return { m_entries.begin() + position, false };
+    }
+    return { insert_new( key, value ), true };
+}
+
+size_t kl::json::ObjectStorage::erase( std::string_view const& key )
+{
+    size_t const position = find_position( key, m_entries.size() );
+    if ( position >= m_entries.size() )
+        return 0;
+
+    m_entries.erase( m_entries.begin() + position );
+    rebuild_index();
+    return 1;
+}
+
+void kl::json::ObjectStorage::append( ObjectKey const& key, Ref<Container> const& value )
+{
+    m_entries.emplace_back( key, value );
+}
+
+void kl::json::ObjectStorage::rebuild()
+{
+    auto compare = []( Entry const& first, Entry const& second )
+    {
+        return first.first < second.first;
+    };
+    if ( m_order == KeyOrder::SORTED && !std::is_sorted( m_entries.begin(), m_entries.end(), compare ) )
+        std::stable_sort( m_entries.begin(), m_entries.end(), compare );
+
+    m_index.clear();
+    if ( m_entries.size() > LINEAR_LIMIT )
+        m_index.assign( std::bit_ceil( m_entries.size() * 2 ), 0 );
+
+    size_t count = 0;
+    for ( size_t i = 0; i < m_entries.size(); i++ )
+    {
+        size_t const existing = find_position( m_entries[i].first, count );
+        if ( existing < count )
+        {
+            m_entries[existing].second = std::move( m_entries[i].second );
+            continue;
+        }
+        if ( count != i )
+            m_entries[count] = std::move( m_entries[i] );
+        index_entry( count );
+        count += 1;
+    }
+    m_entries.resize( count );
+    m_unsorted = false;
+}
+
+// Const readers can share an object that was built out of order, so the first one to iterate sorts it under the lock.
+void kl::json::ObjectStorage::sort_entries() const
+{
+    if ( !m_unsorted.load( std::memory_order_acquire ) )
+        return;
+
+    static std::mutex mutex;
+    std::lock_guard const lock{ mutex };
+    if ( !m_unsorted.load( std::memory_order_relaxed ) )
+        return;
+
+    std::sort( m_entries.begin(), m_entries.end(), []( Entry const& first, Entry const& second )
+    {
+        return first.first < second.first;
+    } );
+    rebuild_index();
+    m_unsorted.store( false, std::memory_order_release );
+}
+
+size_t kl::json::ObjectStorage::find_position( std::string_view const& key, size_t count ) const
+{
+    if ( m_index.empty() )
+    {
+        for ( size_t i = 0; i < count; i++ )
+        {
+            if ( m_entries[i].first == key )
+                return i;
+        }
+        return count;
+    }
+
+    size_t const mask = m_index.size() - 1;
+    for ( size_t slot = string_hash{}(key) & mask; m_index[slot] != 0; slot = (slot + 1) & mask )
+    {
+        size_t const position = m_index[slot] - 1;
+        if ( m_entries[position].first == key )
+            return position;
+    }
+    return count;
+}
+
+kl::json::ObjectStorage::iterator kl::json::ObjectStorage::insert_new( ObjectKey const& key, Ref<Container> const& value )
+{
+    if ( m_order == KeyOrder::SORTED && !m_entries.empty() && key < m_entries.back().first )
+        m_unsorted = true;
+
+    size_t const position = m_entries.size();
+    m_entries.emplace_back( key, value );
+    if ( m_entries.size() > LINEAR_LIMIT && m_entries.size() * 2 > m_index.size() )
+        rebuild_index();
+    else
+        index_entry( position );
+    return m_entries.begin() + position;
+}
+
+void kl::json::ObjectStorage::index_entry( size_t position ) const
+{
+    if ( m_index.empty() )
+        return;
+
+    size_t const mask = m_index.size() - 1;
+    size_t slot = string_hash{}(m_entries[position].first) & mask;
+    while ( m_index[slot] != 0 )
+        slot = (slot + 1) & mask;
+    m_index[slot] = uint32_t( position + 1 );
+}
+
+void kl::json::ObjectStorage::rebuild_index() const
+{
+    m_index.clear();
+    if ( m_entries.size() <= LINEAR_LIMIT )
+        return;
+
+    m_index.assign( std::bit_ceil( m_entries.size() * 2 ), 0 );
+    for ( size_t i = 0; i < m_entries.size(); i++ )
+        index_entry( i );
+}
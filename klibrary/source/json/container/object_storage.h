@@ -0,0 +1,121 @@
+#pragma once
+
+#include "json/container/container.h"
+#include "utility/format/strings.h"
+
+
+namespace kl::json
+{
+enum struct KeyOrder : int32_t
+{
+    SORTED = 0,
+    INSERTION,
+};
+}
+
+namespace kl::json
+{
+// Parsed objects share interned key strings, so the count is atomic for objects copied or freed on different threads.
+struct ObjectKey
+{
+    ObjectKey();
+
+    template<typename T>
+        requires std::is_convertible_v<T const&, std::string_view>
+    ObjectKey( T const& value )
+        : m_value( new std::string( std::string_view{ value } ) )
+    {}
+
+    operator std::string_view() const;
+    operator std::string const&() const;
+
+    bool operator==( ObjectKey const& other ) const;
+    bool operator<( ObjectKey const& other ) const;
+
+    template<typename T>
+        requires std::is_convertible_v<T const&, std::string_view>
+    bool operator==( T const& other ) const
+    {
+        return std::string_view{ *this } == std::string_view{ other };
+    }
+
+private:
+    AtomicRef<std::string> m_value;
+};
+
+inline std::ostream& operator<<( std::ostream& stream, ObjectKey const& key )
+{
+    return stream << std::string_view{ key };
+}
+}
+
+namespace kl::json
+{
+struct KeyTable
+{
+    ObjectKey intern( std::string_view const& key );
+    void clear();
+
+private:
+    std::unordered_map<std::string_view, ObjectKey, string_hash> m_keys;
+};
+}
+
+namespace kl::json
+{
+// append() skips the order and duplicate checks, rebuild() restores them afterwards.
+// Out of order inserts in SORTED mode are appended and sorted on the next iteration, which
+// moves the entries like any insert does, so iterators and references taken before it are invalid.
+struct ObjectStorage
+{
+    using Entry = std::pair<ObjectKey, Ref<Container>>;
+    using iterator = std::vector<Entry>::iterator;
+    using const_iterator = std::vector<Entry>::const_iterator;
+
+    static constexpr size_t LINEAR_LIMIT = 8;
+
+    ObjectStorage( KeyOrder order = KeyOrder::SORTED );
+    ObjectStorage( ObjectStorage const& other );
+    ObjectStorage( ObjectStorage&& other ) noexcept;
+
+    ObjectStorage& operator=( ObjectStorage const& other );
+    ObjectStorage& operator=( ObjectStorage&& other ) noexcept;
+
+    KeyOrder order() const;
+    size_t size() const;
+    bool empty() const;
+    void reserve( size_t capacity );
+    void clear();
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    iterator find( std::string_view const& key );
+    const_iterator find( std::string_view const& key ) const;
+    bool contains( std::string_view const& key ) const;
+
+    Ref<Container>& at( std::string_view const& key );
+    Ref<Container> const& at( std::string_view const& key ) const;
+    Ref<Container>& operator[]( std::string_view const& key );
+
+    std::pair<iterator, bool> insert_or_assign( ObjectKey const& key, Ref<Container> const& value );
+    size_t erase( std::string_view const& key );
+
+    void append( ObjectKey const& key, Ref<Container> const& value );
+    void rebuild();
+
+private:
+    KeyOrder m_order = KeyOrder::SORTED;
+    mutable std::vector<Entry> m_entries;
+    mutable std::vector<uint32_t> m_index;
+    mutable std::atomic<bool> m_unsorted = false;
+
+    void sort_entries() const;
+    size_t find_position( std::string_view const& key, size_t count ) const;
+    iterator insert_new( ObjectKey const& key, Ref<Container> const& value );
+    void index_entry( size_t position ) const;
+    void rebuild_index() const;
+};
+}
@@ -0,0 +1,410 @@
+#include "klibrary.h"
+
+
+namespace kl::json
+{
+struct DocumentBuilder
+{
+    Document& document;
+
+    DocumentBuilder( Document& document )
+        : document( document )
+    {}
+
+    bool on_object_start()
+    {
+        m_frames.push_back( m_pending.size() );
+        return true;
+    }
+
+    bool on_array_start()
+    {
+        m_frames.push_back( m_pending.size() );
+        return true;
+    }
+
+    bool on_object_end()
+    {
+        if ( (m_pending.size() - m_frames.back()) % 2 )
+            m_pending.pop_back();
+        close( NodeType::OBJECT, 2 );
+        return true;
+    }
+
+    bool on_array_end()
+    {
+        close( NodeType::ARRAY, 1 );
+        return true;
+    }
+
+    bool on_key( std::string_view const& key )
+    {
+        m_pending.push_back( make_string( key ) );
+        return true;
+    }
+
+    bool on_null()
+    {
+        return push( { NodeType::VAL_NULL } );
+    }
+
+    bool on_bool( bool value )
+    {
+        return push( { value ? NodeType::VAL_TRUE : NodeType::VAL_FALSE } );
+    }
+
+    bool on_number( std::string_view const& value )
+    {
+        // Dropping the value would leave its key staged and shift every later member, so it fails the parse.
+        std::optional<Number> number = Number::parse( value );
+        if ( !number )
+            return false;
+        return push( make_number( number.value() ) );
+    }
+
+    bool on_string( std::string_view const& value )
+    {
+        return push( make_string( value ) );
+    }
+
+    void load( Container const& container )
+    {
+        Literal const* literal = dynamic_cast<Literal const*>(&container);
+        if ( Object const* object = dynamic_cast<Object const*>(&container) )
+        {
+            on_object_start();
+            for ( auto& [key, value] : *object )
+            {
+                on_key( key );
+                load( *value );
+            }
+            on_object_end();
+        }
+        else if ( Array const* array = dynamic_cast<Array const*>(&container) )
+        {
+            on_array_start();
+            for ( auto& value : *array )
+                load( *value );
+            on_array_end();
+        }
+        else if ( auto value = container.get_bool() )
+        {
+            on_bool( value.value() );
+        }
+        else if ( auto number = literal ? literal->get_number() : std::nullopt )
+        {
+            push( make_number( number.value() ) );
+        }
+        else if ( auto value = container.get_double() )
+        {
+            push( make_number( value.value() ) );
+        }
+        else if ( auto value = container.get_string() )
+        {
+            on_string( value.value() );
+        }
+        else
+        {
+            on_null();
+        }
+    }
+
+private:
+    std::vector<Node> m_pending;
+    std::vector<size_t> m_frames;
+    std::vector<uint32_t> m_order;
+
+    static Node make_number( Number const& value )
+    {
+        Node node{ NodeType::LIT_NUMBER, uint8_t( value.type() ) };
+        switch ( value.type() )
+        {
+        case NumberType::INTEGER:
+            node.integer = value.as<int64_t>();
+            break;
+
+        case NumberType::UNSIGNED:
+            node.unsigned_integer = value.as<uint64_t>();
+            break;
+
+        case NumberType::DOUBLE:
+            node.number = value.as<double>();
+            break;
+        }
+        return node;
+    }
+
+    Node make_string( std::string_view const& value )
+    {
+        Node node{ NodeType::LIT_STRING, 0, uint32_t( value.size() ) };
+        node.offset = document.m_strings.size();
+        document.m_strings.append( value );
+        return node;
+    }
+
+    bool push( Node const& node )
+    {
+        if ( m_frames.empty() )
+        {
+            document.m_root = node;
+        }
+        else
+        {
+            m_pending.push_back( node );
+        }
+        return true;
+    }
+
+    void close( NodeType type, size_t stride )
+    {
+        size_t const first = m_frames.back();
+        m_frames.pop_back();
+
+        Node node{ type, 0, uint32_t( (m_pending.size() - first) / stride ) };
+        node.offset = document.m_nodes.size();
+        document.m_nodes.insert( document.m_nodes.end(), m_pending.begin() + first, m_pending.end() );
+        m_pending.resize( first );
+        if ( type == NodeType::OBJECT && node.size >= Document::SORTED_KEYS_SIZE )
+            sort_keys( node );
+        push( node );
+    }
+
+    // The sorted member indices are packed four to a node, stable sorting keeps the first of equal keys first.
+    void sort_keys( Node const& object )
+    {
+        NodeView const view{ &document, &object };
+        m_order.resize( object.size );
+        std::iota( m_order.begin(), m_order.end(), 0 );
+        std::stable_sort( m_order.begin(), m_order.end(), [&]( uint32_t first, uint32_t second )
+        {
+            return view.key( first ) < view.key( second );
+        } );
+
+        size_t const position = document.m_nodes.size();
+        document.m_nodes.resize( position + (m_order.size() + 3) / 4 );
+        memcpy( reinterpret_cast<byte*>(&document.m_nodes[position]), m_order.data(), m_order.size() * sizeof( uint32_t ) );
+    }
+};
+}
+
+kl::json::NodeView::NodeView()
+{}
+
+kl::json::NodeView::NodeView( Document const* document, Node const* node )
+    : m_document( document ), m_node( node )
+{}
+
+kl::json::NodeView::operator bool() const
+{
+    return (bool) m_node;
+}
+
+kl::json::NodeType kl::json::NodeView::type() const
+{
+    return m_node ? m_node->type : NodeType::VAL_NULL;
+}
+
+std::optional<bool> kl::json::NodeView::get_bool() const
+{
+    if ( type() == NodeType::VAL_TRUE )
+        return { true };
+    if ( type() == NodeType::VAL_FALSE )
+        return { false };
+    return std::nullopt;
+}
+
+std::optional<kl::json::Number> kl::json::NodeView::get_number() const
+{
+    if ( type() != NodeType::LIT_NUMBER )
+        return std::nullopt;
+
+    switch ( NumberType( m_node->number_type ) )
+    {
+    case NumberType::INTEGER:
+        return Number{ m_node->integer };
+
+    case NumberType::UNSIGNED:
+        return Number{ m_node->unsigned_integer };
+    }
+    return Number{ m_node->number };
+}
+
+std::optional<double> kl::json::NodeView::get_double() const
+{
+    if ( auto number = get_number() )
+        return number->as<double>();
+    return std::nullopt;
+}
+
+std::optional<int64_t> kl::json::NodeView::get_long() const
+{
+    if ( auto number = get_number() )
+        return number->as<int64_t>();
+    return std::nullopt;
+}
+
+std::optional<std::string_view> kl::json::NodeView::get_string() const
+{
+    if ( type() != NodeType::LIT_STRING )
+        return std::nullopt;
+    return std::string_view{ m_document->m_strings }.substr( m_node->offset, m_node->size );
+}
+
+size_t kl::json::NodeView::size() const
+{
+    if ( type() != NodeType::OBJECT && type() != NodeType::ARRAY )
+        return 0;
+    return m_node->size;
+}
+
+std::string_view kl::json::NodeView::key( size_t index ) const
+{
+    if ( type() != NodeType::OBJECT || index >= m_node->size )
+        return {};
+    return NodeView{ m_document, &m_document->m_nodes[m_node->offset + index * 2] }.get_string().value_or( "" );
+}
+
+kl::json::NodeView kl::json::NodeView::operator[]( size_t index ) const
+{
+    if ( index >= size() )
+        return {};
+    if ( m_node->type == NodeType::OBJECT )
+        return { m_document, &m_document->m_nodes[m_node->offset + index * 2 + 1] };
+    return { m_document, &m_document->m_nodes[m_node->offset + index] };
+}
+
+kl::json::NodeView kl::json::NodeView::operator[]( std::string_view const& key ) const
+{
+    if ( type() != NodeType::OBJECT )
+        return {};
+
+    if ( m_node->size < Document::SORTED_KEYS_SIZE )
+    {
+        for ( size_t i = 0; i < m_node->size; i++ )
+        {
+            if ( this->key( i ) == key )
+                return (*this)[i];
+        }
+        return {};
+    }
+
+    byte const* order = reinterpret_cast<byte const*>(&m_document->m_nodes[m_node->offset + m_node->size * 2]);
+    auto member = [&]( size_t position )
+    {
+        uint32_t index = 0;
+        memcpy( &index, order + position * sizeof( uint32_t ), sizeof( uint32_t ) );
+        return index;
+    };
+
+    size_t first = 0;
+    size_t count = m_node->size;
+    while ( count > 0 )
+    {
+        size_t const step = count / 2;
+        if ( this->key( member( first + step ) ) < key )
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+    if ( first < m_node->size && this->key( member( first ) ) == key )
+        return (*this)[member( first )];
+    return {};
+}
+
+kl::json::Document::Document()
+{}
+
+kl::json::Document::Document( std::string_view const& data )
+{
+    parse( data );
+}
+
+kl::json::Document::Document( Container const& container )
+{
+    load( container );
+}
+
+bool kl::json::Document::parse( std::string_view const& data )
+{
+    clear();
+    DocumentBuilder builder{ *this };
+    return Parser::parse_events( data, builder );
+}
+
+void kl::json::Document::load( Container const& container )
+{
+    clear();
+    DocumentBuilder builder{ *this };
+    builder.load( container );
+}
+
+void kl::json::Document::clear()
+{
+    m_nodes.clear();
+    m_strings.clear();
+    m_root = {};
+}
+
+kl::json::NodeView kl::json::Document::root() const
+{
+    return { this, &m_root };
+}
+
+size_t kl::json::Document::node_count() const
+{
+    return m_nodes.size() + 1;
+}
+
+size_t kl::json::Document::byte_size() const
+{
+    return m_nodes.size() * sizeof( Node ) + m_strings.size();
+}
+
+namespace kl::json
+{
+static Ref<Container> node_to_container( NodeView const& view )
+{
+    switch ( view.type() )
+    {
+    case NodeType::OBJECT:
+    {
+        Ref object = new Object();
+        object->reserve( view.size() );
+        for ( size_t i = 0; i < view.size(); i++ )
+            object->append( view.key( i ), node_to_container( view[i] ) );
+        object->rebuild();
+        return object;
+    }
+
+    case NodeType::ARRAY:
+    {
+        Ref array = new Array();
+        array->reserve( view.size() );
+        for ( size_t i = 0; i < view.size(); i++ )
+            array->push_back( node_to_container( view[i] ) );
+        return array;
+    }
+
+    case NodeType::VAL_FALSE:
+    case NodeType::VAL_TRUE:
+        return make_bool( view.get_bool().value() );
+
+    case NodeType::LIT_NUMBER:
+        return make_number( view.get_number().value() );
+
+    case NodeType::LIT_STRING:
+        return make_string( view.get_string().value() );
+    }
+    return make_null();
+}
+}
+
+kl::Ref<kl::json::Container> kl::json::Document::to_container() const
+{
+    return node_to_container( root() );
+}
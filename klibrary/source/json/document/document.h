@@ -0,0 +1,98 @@
+#pragma once
+
+#include "json/container/container.h"
+
+
+namespace kl::json
+{
+enum struct NodeType : uint8_t
+{
+    VAL_NULL = 0,
+    VAL_FALSE,
+    VAL_TRUE,
+    LIT_NUMBER,
+    LIT_STRING,
+    OBJECT,
+    ARRAY,
+};
+}
+
+namespace kl::json
+{
+struct Node
+{
+    NodeType type = NodeType::VAL_NULL;
+    uint8_t number_type = 0;
+    uint32_t size = 0;
+    union
+    {
+        int64_t integer;
+        uint64_t unsigned_integer;
+        double number;
+        uint64_t offset = 0;
+    };
+};
+
+static_assert(sizeof( Node ) == 16);
+}
+
+namespace kl::json
+{
+struct Document;
+
+struct NodeView
+{
+    NodeView();
+    NodeView( Document const* document, Node const* node );
+
+    explicit operator bool() const;
+    NodeType type() const;
+
+    std::optional<bool> get_bool() const;
+    std::optional<Number> get_number() const;
+    std::optional<double> get_double() const;
+    std::optional<int64_t> get_long() const;
+    std::optional<std::string_view> get_string() const;
+
+    size_t size() const;
+    std::string_view key( size_t index ) const;
+    NodeView operator[]( size_t index ) const;
+    NodeView operator[]( std::string_view const& key ) const;
+
+private:
+    Document const* m_document = nullptr;
+    Node const* m_node = nullptr;
+};
+}
+
+namespace kl::json
+{
+// Objects with at least SORTED_KEYS_SIZE members keep their member indices sorted by key right
+// after the members, so key lookups in them are binary searches.
+struct Document : NoCopy
+{
+    friend struct NodeView;
+    friend struct DocumentBuilder;
+
+    static constexpr uint32_t SORTED_KEYS_SIZE = 16;
+
+    Document();
+    Document( std::string_view const& data );
+    Document( Container const& container );
+
+    bool parse( std::string_view const& data );
+    void load( Container const& container );
+    void clear();
+
+    NodeView root() const;
+    size_t node_count() const;
+    size_t byte_size() const;
+
+    Ref<Container> to_container() const;
+
+private:
+    std::vector<Node> m_nodes;
+    std::string m_strings;
+    Node m_root = {};
+};
+}
@@ -0,0 +1,469 @@
+#include "klibrary.h"
+
+
+kl::json::LazyView::LazyView()
+{}
+
+kl::json::LazyView::LazyView( LazyDocument const* document, size_t index )
+    : m_document( document ), m_index( index )
+{}
+
+kl::json::LazyView::operator bool() const
+{
+    return m_document && m_index < m_document->m_indices.size();
+}
+
+kl::json::NodeType kl::json::LazyView::type() const
+{
+    if ( !*this )
+        return NodeType::VAL_NULL;
+
+    switch ( m_document->at( m_index ) )
+    {
+    case Standard::object_start:
+        return NodeType::OBJECT;
+
+    case Standard::array_start:
+        return NodeType::ARRAY;
+
+    case Standard::string:
+        return NodeType::LIT_STRING;
+
+    case Standard::true_val.front():
+        return NodeType::VAL_TRUE;
+
+    case Standard::false_val.front():
+        return NodeType::VAL_FALSE;
+
+    case Standard::null_val.front():
+        return NodeType::VAL_NULL;
+    }
+    return NodeType::LIT_NUMBER;
+}
+
+std::string_view kl::json::LazyView::source() const
+{
+    if ( !*this )
+        return {};
+
+    std::string_view const data = m_document->m_source;
+    size_t const first = m_document->m_indices[m_index];
+    size_t last = first;
+    switch ( type() )
+    {
+    case NodeType::OBJECT:
+    case NodeType::ARRAY:
+    {
+        size_t const close = m_document->close( m_index );
+        last = close < m_document->m_indices.size() ? m_document->m_indices[close] : data.size() - 1;
+        break;
+    }
+
+    case NodeType::LIT_STRING:
+        last = (m_index + 1) < m_document->m_indices.size() ? m_document->m_indices[m_index + 1] : data.size() - 1;
+        break;
+
+    case NodeType::LIT_NUMBER:
+        Parser::read_number( data, last );
+        break;
+
+    default:
+        Parser::read_keyword( data, last );
+        break;
+    }
+    return data.substr( first, last - first + 1 );
+}
+
+std::optional<bool> kl::json::LazyView::get_bool() const
+{
+    if ( type() == NodeType::VAL_TRUE )
+        return { true };
+    if ( type() == NodeType::VAL_FALSE )
+        return { false };
+    return std::nullopt;
+}
+
+std::optional<double> kl::json::LazyView::get_double() const
+{
+    if ( type() != NodeType::LIT_NUMBER )
+        return std::nullopt;
+    if ( auto number = Number::parse( source() ) )
+        return number->as<double>();
+    return std::nullopt;
+}
+
+std::optional<int64_t> kl::json::LazyView::get_long() const
+{
+    if ( type() != NodeType::LIT_NUMBER )
+        return std::nullopt;
+    if ( auto number = Number::parse( source() ) )
+        return number->as<int64_t>();
+    return std::nullopt;
+}
+
+std::optional<std::string> kl::json::LazyView::get_string() const
+{
+    if ( type() != NodeType::LIT_STRING )
+        return std::nullopt;
+
+    std::string_view const content = m_document->raw_string( m_index );
+    if ( content.find( Standard::escaping ) == std::string_view::npos )
+        return std::string{ content };
+
+    std::string result;
+    Lexer::decode_string( content, result );
+    return result;
+}
+
+size_t kl::json::LazyView::size() const
+{
+    NodeType const type = this->type();
+    if ( type != NodeType::OBJECT && type != NodeType::ARRAY )
+        return 0;
+    return m_document->children( m_index ).size();
+}
+
+std::string kl::json::LazyView::key( size_t index ) const
+{
+    if ( type() != NodeType::OBJECT || index >= size() )
+        return {};
+    return LazyView{ m_document, m_document->children( m_index )[index] }.get_string().value_or( "" );
+}
+
+kl::json::LazyView kl::json::LazyView::operator[]( size_t index ) const
+{
+    if ( index >= size() )
+        return {};
+    return m_document->child_value( m_index, m_document->children( m_index )[index] );
+}
+
+kl::json::LazyView kl::json::LazyView::operator[]( std::string_view const& key ) const
+{
+    if ( type() != NodeType::OBJECT )
+        return {};
+
+    LazyView result;
+    std::string decoded;
+    for_each_child( [&]( LazyView const& name, LazyView const& value )
+    {
+        std::string_view raw = m_document->raw_string( name.m_index );
+        if ( raw.find( Standard::escaping ) != std::string_view::npos )
+        {
+            decoded.clear();
+            Lexer::decode_string( raw, decoded );
+            raw = decoded;
+        }
+        if ( raw != key )
+            return true;
+        result = value;
+        return false;
+    } );
+    return result;
+}
+
+kl::json::LazyView kl::json::LazyView::pointer( std::string_view const& path ) const
+{
+    LazyView result = *this;
+    size_t position = 0;
+    while ( result && position < path.size() )
+    {
+        if ( path[position] != '/' )
+            return {};
+
+        size_t end = path.find( '/', position + 1 );
+        if ( end == std::string_view::npos )
+            end = path.size();
+
+        std::string token{ path.substr( position + 1, end - position - 1 ) };
+        replace_all( token, "~1", "/" );
+        replace_all( token, "~0", "~" );
+        position = end;
+
+        if ( result.type() == NodeType::ARRAY )
+        {
+            size_t index = 0;
+            auto [last, error] = std::from_chars( token.data(), token.data() + token.size(), index );
+            if ( token.empty() || error != std::errc{} || last != token.data() + token.size() )
+                return {};
+            result = result[index];
+        }
+        else
+        {
+            result = result[token];
+        }
+    }
+    return result;
+}
+
+// Builds plain containers straight from the structural index, without lexing the source again.
+kl::Ref<kl::json::Container> kl::json::LazyView::to_container() const
+{
+    switch ( type() )
+    {
+    case NodeType::OBJECT:
+    {
+        Ref object = new Object();
+        object->reserve( size() );
+        for_each_child( [&]( LazyView const& key, LazyView const& value )
+        {
+            object->append( key.get_string().value_or( "" ), value.to_container() );
+            return true;
+        } );
+        object->rebuild();
+        return object;
+    }
+
+    case NodeType::ARRAY:
+    {
+        Ref array = new Array();
+        array->reserve( size() );
+        for_each_child( [&]( LazyView const& key, LazyView const& value )
+        {
+            array->push_back( value.to_container() );
+            return true;
+        } );
+        return array;
+    }
+
+    case NodeType::LIT_STRING:
+        return make_string( get_string().value_or( "" ) );
+
+    case NodeType::VAL_TRUE:
+    case NodeType::VAL_FALSE:
+        return make_bool( type() == NodeType::VAL_TRUE );
+
+    case NodeType::VAL_NULL:
+        return make_null();
+    }
+
+    Ref literal = new Literal();
+    if ( !literal->parse_number( source() ) )
+        literal->put_null();
+    return literal;
+}
+
+kl::Ref<kl::json::Container> kl::json::LazyView::materialize() const
+{
+    switch ( type() )
+    {
+    case NodeType::OBJECT:
+        return new Object( source() );
+
+    case NodeType::ARRAY:
+        return new Array( source() );
+    }
+    return new Literal( source() );
+}
+
+kl::json::LazyDocument::LazyDocument()
+{}
+
+kl::json::LazyDocument::LazyDocument( std::string_view const& data )
+{
+    parse( data );
+}
+
+void kl::json::LazyDocument::parse( std::string_view const& data )
+{
+    struct Frame
+    {
+        size_t open = 0;
+        size_t first = 0;
+        size_t key = 0;
+        bool object = false;
+        bool expect_key = true;
+    };
+
+    m_source = data;
+    Scanner::scan( data, Scanner::best_level(), m_indices );
+    m_first_child.resize( m_indices.size() );
+    m_children.clear();
+
+    // Children are collected while brackets are matched and copied out when their container closes, so
+    // every container gets one contiguous list of keys or values, led by its closing index and length.
+    // Only entries of opening brackets are set in m_first_child.
+    std::vector<Frame> stack;
+    std::vector<size_t> pending;
+    auto close_frame = [&]( size_t close )
+    {
+        Frame const& frame = stack.back();
+        m_first_child[frame.open] = m_children.size();
+        m_children.push_back( close );
+        m_children.push_back( pending.size() - frame.first );
+        m_children.insert( m_children.end(), pending.begin() + frame.first, pending.end() );
+        pending.resize( frame.first );
+        stack.pop_back();
+    };
+    auto add_value = [&]( size_t index, bool string )
+    {
+        if ( stack.empty() )
+            return;
+
+        Frame& frame = stack.back();
+        if ( !frame.object )
+        {
+            pending.push_back( index );
+        }
+        else if ( frame.expect_key )
+        {
+            frame.key = index;
+            frame.expect_key = !string;
+        }
+        else
+        {
+            pending.push_back( frame.key );
+            frame.expect_key = true;
+        }
+    };
+
+    for ( size_t i = 0; i < m_indices.size(); i++ )
+    {
+        switch ( at( i ) )
+        {
+        case Standard::object_start:
+        case Standard::array_start:
+            add_value( i, false );
+            stack.push_back( { i, pending.size(), 0, at( i ) == Standard::object_start } );
+            break;
+
+        case Standard::object_end:
+        case Standard::array_end:
+            if ( !stack.empty() )
+                close_frame( i );
+            break;
+
+        case Standard::string:
+            add_value( i, true );
+            i += 1;
+            break;
+
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            add_value( i, false );
+            break;
+
+        case Standard::true_val.front():
+        case Standard::false_val.front():
+        case Standard::null_val.front():
+        {
+            size_t position = m_indices[i];
+            if ( Parser::read_keyword( m_source, position ) )
+                add_value( i, false );
+            break;
+        }
+        }
+    }
+    while ( !stack.empty() )
+        close_frame( m_indices.size() );
+}
+
+std::string_view kl::json::LazyDocument::source() const
+{
+    return m_source;
+}
+
+kl::json::LazyView kl::json::LazyDocument::root() const
+{
+    return { this, skip( 0 ) };
+}
+
+kl::json::LazyView kl::json::LazyDocument::pointer( std::string_view const& path ) const
+{
+    return root().pointer( path );
+}
+
+kl::Ref<kl::json::Container> kl::json::LazyDocument::to_container() const
+{
+    return root().to_container();
+}
+
+char kl::json::LazyDocument::at( size_t index ) const
+{
+    return m_source[m_indices[index]];
+}
+
+size_t kl::json::LazyDocument::skip( size_t index ) const
+{
+    for ( ; index < m_indices.size(); index++ )
+    {
+        switch ( at( index ) )
+        {
+        case Standard::object_start:
+        case Standard::object_end:
+        case Standard::array_start:
+        case Standard::array_end:
+        case Standard::string:
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            return index;
+
+        case Standard::true_val.front():
+        case Standard::false_val.front():
+        case Standard::null_val.front():
+        {
+            size_t position = m_indices[index];
+            if ( Parser::read_keyword( m_source, position ) )
+                return index;
+            break;
+        }
+        }
+    }
+    return index;
+}
+
+size_t kl::json::LazyDocument::next( size_t index ) const
+{
+    switch ( at( index ) )
+    {
+    case Standard::object_start:
+    case Standard::array_start:
+        return close( index ) + 1;
+
+    case Standard::string:
+        return index + 2;
+    }
+    return index + 1;
+}
+
+size_t kl::json::LazyDocument::close( size_t index ) const
+{
+    return m_children[m_first_child[index]];
+}
+
+std::string_view kl::json::LazyDocument::raw_string( size_t index ) const
+{
+    size_t const first = m_indices[index] + 1;
+    size_t const last = (index + 1) < m_indices.size() ? m_indices[index + 1] : m_source.size();
+    return m_source.substr( first, last - first );
+}
+
+std::span<size_t const> kl::json::LazyDocument::children( size_t index ) const
+{
+    size_t const first = m_first_child[index];
+    return { m_children.data() + first + 2, m_children[first + 1] };
+}
+
+kl::json::LazyView kl::json::LazyDocument::child_value( size_t index, size_t child ) const
+{
+    if ( at( index ) == Standard::object_start )
+        return { this, skip( next( child ) ) };
+    return { this, child };
+}
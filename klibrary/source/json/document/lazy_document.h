@@ -0,0 +1,90 @@
+#pragma once
+
+#include "json/document/document.h"
+
+
+namespace kl::json
+{
+struct LazyDocument;
+
+struct LazyView
+{
+    LazyView();
+    LazyView( LazyDocument const* document, size_t index );
+
+    explicit operator bool() const;
+    NodeType type() const;
+    std::string_view source() const;
+
+    std::optional<bool> get_bool() const;
+    std::optional<double> get_double() const;
+    std::optional<int64_t> get_long() const;
+    std::optional<std::string> get_string() const;
+
+    size_t size() const;
+    std::string key( size_t index ) const;
+    LazyView operator[]( size_t index ) const;
+    LazyView operator[]( std::string_view const& key ) const;
+    LazyView pointer( std::string_view const& path ) const;
+
+    Ref<Container> to_container() const;
+    Ref<Container> materialize() const;
+
+    template<typename F>
+    void for_each_child( F const& func ) const;
+
+private:
+    LazyDocument const* m_document = nullptr;
+    size_t m_index = 0;
+};
+}
+
+namespace kl::json
+{
+// Views read from the source data and the document's index, so both have to outlive every view
+// taken from them. Containers built with to_container() are independent copies.
+struct LazyDocument : NoCopy
+{
+    friend struct LazyView;
+
+    LazyDocument();
+    LazyDocument( std::string_view const& data );
+
+    void parse( std::string_view const& data );
+
+    std::string_view source() const;
+    LazyView root() const;
+    LazyView pointer( std::string_view const& path ) const;
+
+    Ref<Container> to_container() const;
+
+private:
+    std::string_view m_source;
+    std::vector<size_t> m_indices;
+    std::vector<size_t> m_first_child;
+    std::vector<size_t> m_children;
+
+    char at( size_t index ) const;
+    size_t skip( size_t index ) const;
+    size_t next( size_t index ) const;
+    size_t close( size_t index ) const;
+    std::string_view raw_string( size_t index ) const;
+    std::span<size_t const> children( size_t index ) const;
+    LazyView child_value( size_t index, size_t child ) const;
+};
+}
+
+template<typename F>
+void kl::json::LazyView::for_each_child( F const& func ) const
+{
+    NodeType const type = this->type();
+    if ( type != NodeType::OBJECT && type != NodeType::ARRAY )
+        return;
+
+    for ( size_t child : m_document->children( m_index ) )
+    {
+        LazyView const key = type == NodeType::OBJECT ? LazyView{ m_document, child } : LazyView{};
+        if ( !func( key, m_document->child_value( m_index, child ) ) )
+            return;
+    }
+}
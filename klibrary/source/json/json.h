@@ -1,11 +1,27 @@
 #pragma once
 
 #include "json/language/standard.h"
+#include "json/language/number.h"
+#include "json/language/scanner.h"
 #include "json/language/lexer.h"
+#include "json/language/parser.h"
+#include "json/language/token_document.h"
+#include "json/language/stream_parser.h"
+#include "json/language/serializer.h"
+#include "json/language/ndjson_reader.h"
 #include "json/container/container.h"
 #include "json/container/literal.h"
+#include "json/container/object_storage.h"
 #include "json/container/object.h"
 #include "json/container/array.h"
+#include "json/container/column_array.h"
+#include "json/document/document.h"
+#include "json/document/lazy_document.h"
+#include "json/query/json_path.h"
+#include "json/binding/binding.h"
+#include "json/binary/binary_io.h"
+#include "json/binary/cbor.h"
+#include "json/binary/message_pack.h"
 
 
 namespace kl::json
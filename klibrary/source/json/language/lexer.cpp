@@ -3,13 +3,10 @@
 
 void kl::json::Lexer::from_escaping( std::string& str )
 {
-    replace_all( str, "\\", "\\\\" );
-    replace_all( str, "\"", "\\\"" );
-    replace_all( str, "\b", "\\b" );
-    replace_all( str, "\f", "\\f" );
-    replace_all( str, "\n", "\\n" );
-    replace_all( str, "\r", "\\r" );
-    replace_all( str, "\t", "\\t" );
+    std::string result;
+    result.reserve( str.size() );
+    encode_string( str, result );
+    str.swap( result );
 }
 
 char kl::json::Lexer::to_escaping( char c )
@@ -25,12 +22,186 @@ char kl::json::Lexer::to_escaping( char c )
     return c;
 }
 
+static std::optional<uint32_t> parse_hex4( std::string_view const& data, size_t i )
+{
+    if ( i + 4 > data.size() )
+        return std::nullopt;
+
+    uint32_t result = 0;
+    char const* last = data.data() + i + 4;
+    auto [end, error] = std::from_chars( data.data() + i, last, result, 16 );
+    if ( error != std::errc{} || end != last )
+        return std::nullopt;
+    return { result };
+}
+
+static void append_utf8( std::string& buffer, uint32_t code )
+{
+    if ( code < 0x80 )
+    {
+        buffer.push_back( char( code ) );
+    }
+    else if ( code < 0x800 )
+    {
+        buffer.push_back( char( 0xC0 | (code >> 6) ) );
+        buffer.push_back( char( 0x80 | (code & 0x3F) ) );
+    }
+    else if ( code < 0x10000 )
+    {
+        buffer.push_back( char( 0xE0 | (code >> 12) ) );
+        buffer.push_back( char( 0x80 | ((code >> 6) & 0x3F) ) );
+        buffer.push_back( char( 0x80 | (code & 0x3F) ) );
+    }
+    else
+    {
+        buffer.push_back( char( 0xF0 | (code >> 18) ) );
+        buffer.push_back( char( 0x80 | ((code >> 12) & 0x3F) ) );
+        buffer.push_back( char( 0x80 | ((code >> 6) & 0x3F) ) );
+        buffer.push_back( char( 0x80 | (code & 0x3F) ) );
+    }
+}
+
+void kl::json::Lexer::decode_string( std::string_view const& content, std::string& buffer )
+{
+    for ( size_t i = 0; i < content.size(); i++ )
+    {
+        if ( content[i] != Standard::escaping )
+        {
+            size_t end = content.find( Standard::escaping, i );
+            if ( end == std::string_view::npos )
+                end = content.size();
+            buffer.append( content.substr( i, end - i ) );
+            i = end - 1;
+            continue;
+        }
+
+        i += 1;
+        if ( i >= content.size() )
+            return;
+
+        std::optional<uint32_t> code = content[i] == 'u' ? parse_hex4( content, i + 1 ) : std::nullopt;
+        if ( !code )
+        {
+            buffer.push_back( to_escaping( content[i] ) );
+            continue;
+        }
+
+        i += 4;
+        if ( code.value() >= 0xD800 && code.value() < 0xDC00 && content.substr( i + 1, 2 ) == "\\u" )
+        {
+            std::optional<uint32_t> low = parse_hex4( content, i + 3 );
+            if ( low && low.value() >= 0xDC00 && low.value() < 0xE000 )
+            {
+                code = 0x10000 + ((code.value() - 0xD800) << 10) + (low.value() - 0xDC00);
+                i += 6;
+            }
+        }
+        append_utf8( buffer, code.value() );
+    }
+}
+
+void kl::json::Lexer::encode_string( std::string_view const& content, std::string& buffer )
+{
+    static constexpr char hex_digits[] = "0123456789abcdef";
+
+    size_t first = 0;
+    for ( size_t i = 0; i < content.size(); i++ )
+    {
+        char const c = content[i];
+        if ( uint8_t( c ) >= 0x20 && c != Standard::string && c != Standard::escaping )
+            continue;
+
+        buffer.append( content.substr( first, i - first ) );
+        first = i + 1;
+        buffer.push_back( Standard::escaping );
+        switch ( c )
+        {
+        case Standard::string:
+        case Standard::escaping:
+            buffer.push_back( c );
+            break;
+
+        case '\b':
+            buffer.push_back( 'b' );
+            break;
+
+        case '\f':
+            buffer.push_back( 'f' );
+            break;
+
+        case '\n':
+            buffer.push_back( 'n' );
+            break;
+
+        case '\r':
+            buffer.push_back( 'r' );
+            break;
+
+        case '\t':
+            buffer.push_back( 't' );
+            break;
+
+        default:
+            buffer.append( "u00" );
+            buffer.push_back( hex_digits[uint8_t( c ) >> 4] );
+            buffer.push_back( hex_digits[uint8_t( c ) & 15] );
+            break;
+        }
+    }
+    buffer.append( content.substr( first ) );
+}
+
+void kl::json::Lexer::encode_number( double value, std::string& buffer )
+{
+    if ( !std::isfinite( value ) )
+    {
+        buffer.append( Standard::null_val );
+        return;
+    }
+
+    char digits[32] = {};
+    std::to_chars_result result = {};
+    if ( value == std::trunc( value ) && std::abs( value ) <= 9007199254740992.0 )
+    {
+        result = std::to_chars( digits, digits + sizeof( digits ), int64_t( value ) );
+    }
+    else
+    {
+        result = std::to_chars( digits, digits + sizeof( digits ), value );
+    }
+    buffer.append( digits, result.ptr );
+}
+
+void kl::json::Lexer::encode_number( Number const& value, std::string& buffer )
+{
+    char digits[32] = {};
+    std::to_chars_result result = {};
+    switch ( value.type() )
+    {
+    case NumberType::INTEGER:
+        result = std::to_chars( digits, digits + sizeof( digits ), value.as<int64_t>() );
+        break;
+
+    case NumberType::UNSIGNED:
+        result = std::to_chars( digits, digits + sizeof( digits ), value.as<uint64_t>() );
+        break;
+
+    default:
+        encode_number( value.as<double>(), buffer );
+        return;
+    }
+    buffer.append( digits, result.ptr );
+}
+
 std::vector<kl::json::Token> kl::json::Lexer::parse( std::string_view const& data )
 {
+    std::vector<size_t> const indices = Scanner::scan( data );
+
     std::vector<Token> tokens;
-    tokens.reserve( data.size() / 4 );
-    for ( size_t i = 0; i < data.size(); i++ )
+    tokens.reserve( indices.size() );
+    for ( size_t k = 0; k < indices.size(); k++ )
     {
+        size_t i = indices[k];
         switch ( data[i] )
         {
         case Standard::object_start:
@@ -50,8 +221,11 @@ std::vector<kl::json::Token> kl::json::Lexer::parse( std::string_view const& dat
             break;
 
         case Standard::string:
-            parse_string( data, tokens, i );
+        {
+            size_t const end = (k + 1) < indices.size() ? indices[++k] : data.size();
+            parse_string( data.substr( i + 1, end - i - 1 ), tokens );
             break;
+        }
 
         case '-':
         case '0':
@@ -83,28 +257,16 @@ std::vector<kl::json::Token> kl::json::Lexer::parse( std::string_view const& dat
     return tokens;
 }
 
-void kl::json::Lexer::parse_string( std::string_view const& data, std::vector<Token>& tokens, size_t& i )
+void kl::json::Lexer::parse_string( std::string_view const& content, std::vector<Token>& tokens )
 {
     auto& buffer = tokens.emplace_back( TokenType::LIT_STRING ).value;
-    for ( i += 1; i < data.size(); i++ )
+    if ( content.find( Standard::escaping ) == std::string_view::npos )
     {
-        switch ( data[i] )
-        {
-        case Standard::string:
-            return;
-
-        case Standard::escaping:
-            i += 1;
-            if ( i >= data.size() )
-                return;
-            buffer.push_back( to_escaping( data[i] ) );
-            break;
-
-        default:
-            buffer.push_back( data[i] );
-            break;
-        }
+        buffer.assign( content );
+        return;
     }
+    buffer.reserve( content.size() );
+    decode_string( content, buffer );
 }
 
 void kl::json::Lexer::parse_number( std::string_view const& data, std::vector<Token>& tokens, size_t& i )
@@ -115,6 +277,7 @@ void kl::json::Lexer::parse_number( std::string_view const& data, std::vector<To
         switch ( data[i] )
         {
         case '-':
+        case '+':
         case '.':
         case 'e':
         case 'E':
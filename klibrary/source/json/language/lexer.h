@@ -1,6 +1,7 @@
 #pragma once
 
-#include "json/language/standard.h"
+#include "json/language/scanner.h"
+#include "json/language/number.h"
 
 
 namespace kl::json
@@ -9,11 +10,15 @@ struct Lexer
 {
     static void from_escaping( std::string& str );
     static char to_escaping( char c );
+    static void decode_string( std::string_view const& content, std::string& buffer );
+    static void encode_string( std::string_view const& content, std::string& buffer );
+    static void encode_number( double value, std::string& buffer );
+    static void encode_number( Number const& value, std::string& buffer );
 
     static std::vector<Token> parse( std::string_view const& data );
 
 private:
-    static void parse_string( std::string_view const& data, std::vector<Token>& tokens, size_t& i );
+    static void parse_string( std::string_view const& content, std::vector<Token>& tokens );
     static void parse_number( std::string_view const& data, std::vector<Token>& tokens, size_t& i );
     static void parse_null( std::string_view const& data, std::vector<Token>& tokens, size_t& i );
     static void parse_false( std::string_view const& data, std::vector<Token>& tokens, size_t& i );
@@ -0,0 +1,172 @@
+#include "klibrary.h"
+
+
+uint64_t kl::json::NdjsonReader::read( std::string_view const& data, Callback const& callback, DeliveryOrder order )
+{
+    std::vector<std::string_view> lines;
+    size_t const consumed = split_lines( data, lines );
+    if ( consumed < data.size() )
+        lines.push_back( data.substr( consumed ) );
+    return deliver( lines, 0, callback, order );
+}
+
+uint64_t kl::json::NdjsonReader::read( File const& file, Callback const& callback, DeliveryOrder order, uint64_t chunk_size )
+{
+    auto read_chunk = [&file, chunk_size]( std::string& buffer )
+    {
+        size_t const first = buffer.size();
+        buffer.resize( first + chunk_size );
+        uint64_t const count = file.read( buffer.data() + first, chunk_size );
+        buffer.resize( first + count );
+        return count;
+    };
+
+    std::string current;
+    std::string next;
+    std::vector<std::string_view> lines;
+    uint64_t line_index = 0;
+    uint64_t delivered = 0;
+    bool eof = read_chunk( current ) < chunk_size;
+    while ( !current.empty() )
+    {
+        size_t consumed = split_lines( current, lines, eof );
+        if ( !eof && current.size() - consumed > chunk_size )
+            consumed = split_lines( current, lines, true );
+        if ( eof && consumed < current.size() )
+            lines.push_back( std::string_view{ current }.substr( consumed ) );
+
+        next.assign( current, eof ? current.size() : consumed );
+        std::future<uint64_t> pending;
+        if ( !eof )
+            pending = std::async( std::launch::async, read_chunk, std::ref( next ) );
+
+        delivered += deliver( lines, line_index, callback, order );
+        line_index += lines.size();
+
+        if ( pending.valid() )
+            eof = pending.get() < chunk_size;
+        current.swap( next );
+        next.clear();
+    }
+    return delivered;
+}
+
+size_t kl::json::NdjsonReader::split_lines( std::string_view const& data, std::vector<std::string_view>& lines, bool complete )
+{
+    lines.clear();
+    bool in_string = false;
+    size_t first = 0;
+    size_t first_break = std::string_view::npos;
+    auto resync = [&]
+    {
+        lines.push_back( data.substr( first, first_break - first ) );
+        size_t const last = first_break;
+        first = first_break + 1;
+        first_break = std::string_view::npos;
+        in_string = false;
+        return last;
+    };
+    for ( size_t i = 0; i <= data.size(); i++ )
+    {
+        if ( i == data.size() )
+        {
+            if ( !complete || !in_string || first_break == std::string_view::npos )
+                break;
+            i = resync();
+            continue;
+        }
+
+        char const c = data[i];
+        if ( in_string )
+        {
+            if ( c == Standard::escaping )
+            {
+                if ( i + 1 < data.size() )
+                    i += 1;
+            }
+            else if ( c == Standard::string )
+            {
+                in_string = false;
+            }
+            else if ( c == '\n' && first_break == std::string_view::npos )
+            {
+                first_break = i;
+            }
+        }
+        else if ( c == Standard::string )
+        {
+            in_string = true;
+        }
+        else if ( c == '\n' )
+        {
+            std::string_view const line = data.substr( first, i - first );
+            if ( first_break != std::string_view::npos && !parse_line( line ) )
+            {
+                i = resync();
+                continue;
+            }
+            lines.push_back( line );
+            first = i + 1;
+            first_break = std::string_view::npos;
+        }
+    }
+    return first;
+}
+
+kl::Ref<kl::json::Container> kl::json::NdjsonReader::parse_line( std::string_view const& line )
+{
+    size_t const first = line.find_first_not_of( " \t\r" );
+    if ( first == std::string_view::npos )
+        return {};
+
+    Ref<Container> result;
+    switch ( line[first] )
+    {
+    case Standard::object_start:
+        result = new Object();
+        break;
+
+    case Standard::array_start:
+        result = new Array();
+        break;
+
+    default:
+        result = new Literal();
+        break;
+    }
+    if ( !Parser::parse( line, *result ) )
+        return {};
+    return result;
+}
+
+uint64_t kl::json::NdjsonReader::deliver( std::vector<std::string_view> const& lines, uint64_t first_line, Callback const& callback, DeliveryOrder order )
+{
+    std::atomic<uint64_t> delivered = 0;
+    if ( order == DeliveryOrder::UNORDERED )
+    {
+        async_for<size_t>( 0, lines.size(), [&]( size_t i )
+        {
+            if ( lines[i].find_first_not_of( " \t\r" ) == std::string_view::npos )
+                return;
+
+            callback( first_line + i, parse_line( lines[i] ) );
+            delivered += 1;
+        } );
+        return delivered;
+    }
+
+    std::vector<Ref<Container>> results( lines.size() );
+    async_for<size_t>( 0, lines.size(), [&]( size_t i )
+    {
+        results[i] = parse_line( lines[i] );
+    } );
+    for ( size_t i = 0; i < lines.size(); i++ )
+    {
+        if ( lines[i].find_first_not_of( " \t\r" ) == std::string_view::npos )
+            continue;
+
+        callback( first_line + i, results[i] );
+        delivered += 1;
+    }
+    return delivered;
+}
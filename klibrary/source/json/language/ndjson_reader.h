@@ -0,0 +1,37 @@
+#pragma once
+
+#include "json/language/parser.h"
+#include "memory/files/file.h"
+
+
+namespace kl::json
+{
+enum struct DeliveryOrder : int32_t
+{
+    ORDERED = 0,
+    UNORDERED,
+};
+}
+
+namespace kl::json
+{
+// Blank lines are skipped and lines that fail to parse are delivered as empty refs.
+// Unordered delivery calls the callback from worker threads as soon as a line is parsed.
+// Strings can hold raw newlines, but a line that does that and then fails to parse, or whose string is still
+// open at the end of complete data, is cut at its first raw newline so an unbalanced quote costs only that line.
+struct NdjsonReader
+{
+    using Callback = std::function<void( uint64_t line, Ref<Container> const& value )>;
+
+    static constexpr uint64_t DEFAULT_CHUNK_SIZE = 16 * 1024 * 1024;
+
+    static uint64_t read( std::string_view const& data, Callback const& callback, DeliveryOrder order = DeliveryOrder::ORDERED );
+    static uint64_t read( File const& file, Callback const& callback, DeliveryOrder order = DeliveryOrder::ORDERED, uint64_t chunk_size = DEFAULT_CHUNK_SIZE );
+
+    static size_t split_lines( std::string_view const& data, std::vector<std::string_view>& lines, bool complete = true );
+    static Ref<Container> parse_line( std::string_view const& line );
+
+private:
+    static uint64_t deliver( std::vector<std::string_view> const& lines, uint64_t first_line, Callback const& callback, DeliveryOrder order );
+};
+}
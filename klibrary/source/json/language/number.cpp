@@ -0,0 +1,96 @@
+#include "klibrary.h"
+
+
+kl::json::Number::Number()
+{}
+
+std::optional<kl::json::Number> kl::json::Number::parse( std::string_view const& text )
+{
+    std::string_view digits = text;
+    if ( !digits.empty() && digits.front() == '+' )
+        digits.remove_prefix( 1 );
+    if ( digits.empty() )
+        return std::nullopt;
+
+    char const* first = digits.data();
+    char const* last = first + digits.size();
+    if ( is_integer_text( digits ) )
+    {
+        if ( digits.front() == '-' )
+        {
+            int64_t value = 0;
+            auto [end, error] = std::from_chars( first, last, value );
+            if ( error == std::errc{} && end == last )
+                return Number{ value };
+        }
+        else
+        {
+            uint64_t value = 0;
+            auto [end, error] = std::from_chars( first, last, value );
+            if ( error == std::errc{} && end == last )
+                return Number{ value };
+        }
+    }
+
+    double value = 0.0;
+    auto [end, error] = std::from_chars( first, last, value );
+    if ( end != last )
+        return std::nullopt;
+    if ( error == std::errc::result_out_of_range )
+        return Number{ std::strtod( std::string{ digits }.c_str(), nullptr ) };
+    if ( error != std::errc{} )
+        return std::nullopt;
+    return Number{ value };
+}
+
+bool kl::json::Number::validate( std::string_view const& text )
+{
+    size_t i = 0;
+    auto count_digits = [&]
+    {
+        size_t const first = i;
+        while ( i < text.size() && text[i] >= '0' && text[i] <= '9' )
+            i += 1;
+        return i - first;
+    };
+
+    if ( i < text.size() && (text[i] == '-' || text[i] == '+') )
+        i += 1;
+    size_t mantissa = count_digits();
+    if ( i < text.size() && text[i] == '.' )
+    {
+        i += 1;
+        mantissa += count_digits();
+    }
+    if ( mantissa == 0 )
+        return false;
+
+    if ( i < text.size() && (text[i] == 'e' || text[i] == 'E') )
+    {
+        i += 1;
+        if ( i < text.size() && (text[i] == '-' || text[i] == '+') )
+            i += 1;
+        if ( count_digits() == 0 )
+            return false;
+    }
+    return i == text.size();
+}
+
+bool kl::json::Number::is_integer_text( std::string_view const& text )
+{
+    size_t i = (!text.empty() && text.front() == '-') ? 1 : 0;
+    if ( i == text.size() )
+        return false;
+
+    for ( ; i < text.size(); i++ )
+    {
+        if ( text[i] < '0' || text[i] > '9' )
+            return false;
+    }
+    return true;
+}
+
+kl::json::NumberType kl::json::Number::type() const
+{
+    return NumberType( m_value.index() );
+}
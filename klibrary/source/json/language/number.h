@@ -0,0 +1,62 @@
+#pragma once
+
+#include "json/language/standard.h"
+
+
+namespace kl::json
+{
+enum struct NumberType : int32_t
+{
+    INTEGER = 0,
+    UNSIGNED,
+    DOUBLE,
+};
+}
+
+namespace kl::json
+{
+struct Number
+{
+    Number();
+
+    template<typename T>
+        requires (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+    Number( T value )
+    {
+        if constexpr ( std::is_floating_point_v<T> )
+        {
+            m_value.emplace<double>( value );
+        }
+        else if constexpr ( std::is_signed_v<T> )
+        {
+            m_value.emplace<int64_t>( value );
+        }
+        else if ( uint64_t( value ) > uint64_t( INT64_MAX ) )
+        {
+            m_value.emplace<uint64_t>( value );
+        }
+        else
+        {
+            m_value.emplace<int64_t>( int64_t( value ) );
+        }
+    }
+
+    static std::optional<Number> parse( std::string_view const& text );
+    static bool validate( std::string_view const& text );
+    static bool is_integer_text( std::string_view const& text );
+
+    NumberType type() const;
+
+    template<typename T>
+    T as() const
+    {
+        return std::visit( []( auto value )
+        {
+            return T( value );
+        }, m_value );
+    }
+
+private:
+    std::variant<int64_t, uint64_t, double> m_value;
+};
+}
@@ -0,0 +1,286 @@
+#include "klibrary.h"
+
+
+namespace kl::json
+{
+struct ContainerBuilder
+{
+    Container& root;
+    bool bound = false;
+
+    ContainerBuilder( Container& root )
+        : root( root )
+    {}
+
+    bool on_object_start()
+    {
+        if ( m_stack.empty() )
+        {
+            Object* object = dynamic_cast<Object*>(&root);
+            if ( bound || !object )
+                return false;
+
+            bound = true;
+            m_order = object->order();
+            m_stack.push_back( { object, nullptr } );
+            return true;
+        }
+        Ref object = new Object( m_order );
+        Object* top = &object;
+        insert( std::move( object ) );
+        m_stack.push_back( { top, nullptr } );
+        return true;
+    }
+
+    bool on_array_start()
+    {
+        if ( m_stack.empty() )
+        {
+            Array* array = dynamic_cast<Array*>(&root);
+            if ( bound || !array )
+                return false;
+
+            bound = true;
+            m_stack.push_back( { nullptr, array } );
+            return true;
+        }
+        Ref array = new Array();
+        Array* top = &array;
+        insert( std::move( array ) );
+        m_stack.push_back( { nullptr, top } );
+        return true;
+    }
+
+    bool on_object_end()
+    {
+        if ( Object* object = m_stack.back().object )
+            object->rebuild();
+        m_stack.pop_back();
+        return true;
+    }
+
+    bool on_array_end()
+    {
+        m_stack.pop_back();
+        return true;
+    }
+
+    bool on_key( std::string_view const& key )
+    {
+        m_key = m_keys.intern( key );
+        return true;
+    }
+
+    bool on_null()
+    {
+        if ( m_stack.empty() )
+            return bind_literal( &Container::put_null );
+
+        Ref literal = new Literal();
+        literal->put_null();
+        insert( std::move( literal ) );
+        return true;
+    }
+
+    bool on_bool( bool value )
+    {
+        if ( m_stack.empty() )
+            return bind_literal( &Container::put_bool, value );
+
+        Ref literal = new Literal();
+        literal->put_bool( value );
+        insert( std::move( literal ) );
+        return true;
+    }
+
+    bool on_number( std::string_view const& value )
+    {
+        if ( m_stack.empty() )
+        {
+            if ( Literal* literal = dynamic_cast<Literal*>(&root) )
+            {
+                if ( bound || !literal->parse_number( value ) )
+                    return false;
+
+                bound = true;
+                return true;
+            }
+            std::optional<Number> number = Number::parse( value );
+            if ( !number )
+                return false;
+            return bind_literal( &Container::put_number, number->as<double>() );
+        }
+
+        Ref literal = new Literal();
+        if ( literal->parse_number( value ) )
+            insert( std::move( literal ) );
+        return true;
+    }
+
+    bool on_string( std::string_view const& value )
+    {
+        if ( m_stack.empty() )
+            return bind_literal( &Container::put_string, value );
+
+        Ref literal = new Literal();
+        literal->put_string( value );
+        insert( std::move( literal ) );
+        return true;
+    }
+
+    void finish()
+    {
+        for ( auto& frame : m_stack )
+        {
+            if ( frame.object )
+                frame.object->rebuild();
+        }
+        m_stack.clear();
+    }
+
+private:
+    struct Frame
+    {
+        Object* object = nullptr;
+        Array* array = nullptr;
+    };
+
+    std::vector<Frame> m_stack;
+    KeyTable m_keys;
+    ObjectKey m_key;
+    KeyOrder m_order = KeyOrder::SORTED;
+
+    void insert( Ref<Container>&& container )
+    {
+        Frame& top = m_stack.back();
+        if ( top.object )
+        {
+            top.object->append( m_key, container );
+        }
+        else
+        {
+            top.array->push_back( std::move( container ) );
+        }
+    }
+
+    template<typename F, typename... Args>
+    bool bind_literal( F function, Args const&... args )
+    {
+        if ( bound )
+            return false;
+
+        bound = true;
+        (root.*function)(args...);
+        return true;
+    }
+};
+}
+
+bool kl::json::Parser::parse( std::string_view const& data, Container& root )
+{
+    ContainerBuilder builder{ root };
+    bool const result = parse_events( data, builder );
+    builder.finish();
+    return result;
+}
+
+std::string_view kl::json::Parser::read_string( std::string_view const& data, size_t& i, std::string& scratch )
+{
+    size_t const first = i + 1;
+    size_t end = data.find_first_of( "\"\\", first );
+    bool escaped = false;
+    while ( end != std::string_view::npos && data[end] == Standard::escaping )
+    {
+        escaped = true;
+        end = data.find_first_of( "\"\\", end + 2 );
+    }
+    if ( end == std::string_view::npos )
+        end = data.size();
+
+    i = end;
+    std::string_view const content = data.substr( first, end - first );
+    if ( !escaped )
+        return content;
+
+    scratch.clear();
+    Lexer::decode_string( content, scratch );
+    return scratch;
+}
+
+std::string_view kl::json::Parser::read_number( std::string_view const& data, size_t& i )
+{
+    size_t end = i;
+    for ( ; end < data.size(); end++ )
+    {
+        switch ( data[end] )
+        {
+        case '-':
+        case '+':
+        case '.':
+        case 'e':
+        case 'E':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            continue;
+        }
+        break;
+    }
+    std::string_view const result = data.substr( i, end - i );
+    i = end - 1;
+    return result;
+}
+
+std::optional<kl::json::TokenType> kl::json::Parser::read_keyword( std::string_view const& data, size_t& i )
+{
+    static constexpr std::pair<std::string_view, TokenType> keywords[] = {
+        { Standard::null_val, TokenType::VAL_NULL },
+        { Standard::false_val, TokenType::VAL_FALSE },
+        { Standard::true_val, TokenType::VAL_TRUE },
+    };
+    for ( auto& [keyword, type] : keywords )
+    {
+        if ( data.substr( i, keyword.size() ) == keyword )
+        {
+            i += keyword.size() - 1;
+            return { type };
+        }
+    }
+    return std::nullopt;
+}
+
+void kl::json::Parser::skip_container( std::string_view const& data, size_t& i )
+{
+    int depth = 0;
+    for ( ; i < data.size(); i++ )
+    {
+        switch ( data[i] )
+        {
+        case Standard::object_start:
+        case Standard::array_start:
+            depth += 1;
+            break;
+
+        case Standard::object_end:
+        case Standard::array_end:
+            if ( --depth == 0 )
+                return;
+            break;
+
+        case Standard::string:
+            i = data.find_first_of( "\"\\", i + 1 );
+            while ( i != std::string_view::npos && data[i] == Standard::escaping )
+                i = data.find_first_of( "\"\\", i + 2 );
+            if ( i == std::string_view::npos )
+                i = data.size();
+            break;
+        }
+    }
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "json/language/lexer.h"
+
+
+namespace kl::json
+{
+struct Container;
+}
+
+namespace kl::json
+{
+struct Parser
+{
+    static bool parse( std::string_view const& data, Container& root );
+
+    template<typename H>
+    static bool parse_events( std::string_view const& data, H& handler )
+    {
+        std::vector<Frame> stack;
+        std::string scratch;
+        for ( size_t i = 0; i < data.size(); i++ )
+        {
+            bool const key_expected = !stack.empty() && stack.back().object && stack.back().expect_key;
+            switch ( data[i] )
+            {
+            case Standard::object_start:
+            case Standard::array_start:
+            {
+                if ( key_expected )
+                {
+                    skip_container( data, i );
+                    break;
+                }
+                bool const object = data[i] == Standard::object_start;
+                if ( !(object ? handler.on_object_start() : handler.on_array_start()) )
+                    return false;
+                begin_value( stack );
+                stack.push_back( { object, true } );
+                break;
+            }
+
+            case Standard::object_end:
+            case Standard::array_end:
+                if ( stack.empty() )
+                    break;
+                if ( !(stack.back().object ? handler.on_object_end() : handler.on_array_end()) )
+                    return false;
+                stack.pop_back();
+                if ( stack.empty() )
+                    return true;
+                break;
+
+            case Standard::string:
+            {
+                std::string_view const value = read_string( data, i, scratch );
+                if ( key_expected )
+                {
+                    if ( !handler.on_key( value ) )
+                        return false;
+                    stack.back().expect_key = false;
+                    break;
+                }
+                if ( !handler.on_string( value ) )
+                    return false;
+                if ( !begin_value( stack ) )
+                    return true;
+                break;
+            }
+
+            case '-':
+            case '0':
+            case '1':
+            case '2':
+            case '3':
+            case '4':
+            case '5':
+            case '6':
+            case '7':
+            case '8':
+            case '9':
+            {
+                std::string_view const value = read_number( data, i );
+                if ( key_expected )
+                    break;
+                if ( !handler.on_number( value ) )
+                    return false;
+                if ( !begin_value( stack ) )
+                    return true;
+                break;
+            }
+
+            case Standard::true_val.front():
+            case Standard::false_val.front():
+            case Standard::null_val.front():
+            {
+                std::optional<TokenType> const type = read_keyword( data, i );
+                if ( !type || key_expected )
+                    break;
+                if ( !(type == TokenType::VAL_NULL ? handler.on_null() : handler.on_bool( type == TokenType::VAL_TRUE )) )
+                    return false;
+                if ( !begin_value( stack ) )
+                    return true;
+                break;
+            }
+            }
+        }
+        return false;
+    }
+
+    static std::string_view read_string( std::string_view const& data, size_t& i, std::string& scratch );
+    static std::string_view read_number( std::string_view const& data, size_t& i );
+    static std::optional<TokenType> read_keyword( std::string_view const& data, size_t& i );
+    static void skip_container( std::string_view const& data, size_t& i );
+
+private:
+    struct Frame
+    {
+        bool object = false;
+        bool expect_key = false;
+    };
+
+    static bool begin_value( std::vector<Frame>& stack )
+    {
+        if ( stack.empty() )
+            return false;
+        stack.back().expect_key = true;
+        return true;
+    }
+};
+}
@@ -0,0 +1,219 @@
+#include "klibrary.h"
+
+
+struct BlockMasks
+{
+    uint64_t quote = 0;
+    uint64_t backslash = 0;
+    uint64_t structural = 0;
+    uint64_t whitespace = 0;
+};
+
+static BlockMasks classify_scalar( char const* block )
+{
+    BlockMasks masks{};
+    for ( int i = 0; i < 64; i++ )
+    {
+        uint64_t const bit = uint64_t( 1 ) << i;
+        switch ( block[i] )
+        {
+        case kl::json::Standard::string:
+            masks.quote |= bit;
+            break;
+
+        case kl::json::Standard::escaping:
+            masks.backslash |= bit;
+            break;
+
+        case kl::json::Standard::object_start:
+        case kl::json::Standard::object_end:
+        case kl::json::Standard::array_start:
+        case kl::json::Standard::array_end:
+        case kl::json::Standard::splitter:
+        case kl::json::Standard::assign:
+            masks.structural |= bit;
+            break;
+
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+            masks.whitespace |= bit;
+            break;
+        }
+    }
+    return masks;
+}
+
+static BlockMasks classify_sse42( char const* block )
+{
+    static constexpr char structural_set[16] = {
+        kl::json::Standard::object_start, kl::json::Standard::object_end,
+        kl::json::Standard::array_start, kl::json::Standard::array_end,
+        kl::json::Standard::splitter, kl::json::Standard::assign,
+    };
+    __m128i const structural_chars = _mm_loadu_si128( reinterpret_cast<__m128i const*>(structural_set) );
+    __m128i const quote_char = _mm_set1_epi8( kl::json::Standard::string );
+    __m128i const backslash_char = _mm_set1_epi8( kl::json::Standard::escaping );
+    __m128i const space_char = _mm_set1_epi8( ' ' );
+    __m128i const tab_char = _mm_set1_epi8( '\t' );
+    __m128i const line_char = _mm_set1_epi8( '\n' );
+    __m128i const return_char = _mm_set1_epi8( '\r' );
+
+    BlockMasks masks{};
+    for ( int i = 0; i < 4; i++ )
+    {
+        __m128i const chunk = _mm_loadu_si128( reinterpret_cast<__m128i const*>(block + i * 16) );
+        __m128i const structural = _mm_cmpestrm( structural_chars, 6, chunk, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_UNIT_MASK );
+        __m128i const whitespace = _mm_or_si128(
+            _mm_or_si128( _mm_cmpeq_epi8( chunk, space_char ), _mm_cmpeq_epi8( chunk, tab_char ) ),
+            _mm_or_si128( _mm_cmpeq_epi8( chunk, line_char ), _mm_cmpeq_epi8( chunk, return_char ) ) );
+
+        int const shift = i * 16;
+        masks.quote |= uint64_t( uint16_t( _mm_movemask_epi8( _mm_cmpeq_epi8( chunk, quote_char ) ) ) ) << shift;
+        masks.backslash |= uint64_t( uint16_t( _mm_movemask_epi8( _mm_cmpeq_epi8( chunk, backslash_char ) ) ) ) << shift;
+        masks.structural |= uint64_t( uint16_t( _mm_movemask_epi8( structural ) ) ) << shift;
+        masks.whitespace |= uint64_t( uint16_t( _mm_movemask_epi8( whitespace ) ) ) << shift;
+    }
+    return masks;
+}
+
+static BlockMasks classify_avx2( char const* block )
+{
+    __m256i const quote_char = _mm256_set1_epi8( kl::json::Standard::string );
+    __m256i const backslash_char = _mm256_set1_epi8( kl::json::Standard::escaping );
+    __m256i const object_start_char = _mm256_set1_epi8( kl::json::Standard::object_start );
+    __m256i const object_end_char = _mm256_set1_epi8( kl::json::Standard::object_end );
+    __m256i const array_start_char = _mm256_set1_epi8( kl::json::Standard::array_start );
+    __m256i const array_end_char = _mm256_set1_epi8( kl::json::Standard::array_end );
+    __m256i const splitter_char = _mm256_set1_epi8( kl::json::Standard::splitter );
+    __m256i const assign_char = _mm256_set1_epi8( kl::json::Standard::assign );
+    __m256i const space_char = _mm256_set1_epi8( ' ' );
+    __m256i const tab_char = _mm256_set1_epi8( '\t' );
+    __m256i const line_char = _mm256_set1_epi8( '\n' );
+    __m256i const return_char = _mm256_set1_epi8( '\r' );
+
+    BlockMasks masks{};
+    for ( int i = 0; i < 2; i++ )
+    {
+        __m256i const chunk = _mm256_loadu_si256( reinterpret_cast<__m256i const*>(block + i * 32) );
+        __m256i const brackets = _mm256_or_si256(
+            _mm256_or_si256( _mm256_cmpeq_epi8( chunk, object_start_char ), _mm256_cmpeq_epi8( chunk, object_end_char ) ),
+            _mm256_or_si256( _mm256_cmpeq_epi8( chunk, array_start_char ), _mm256_cmpeq_epi8( chunk, array_end_char ) ) );
+        __m256i const structural = _mm256_or_si256( brackets,
+            _mm256_or_si256( _mm256_cmpeq_epi8( chunk, splitter_char ), _mm256_cmpeq_epi8( chunk, assign_char ) ) );
+        __m256i const whitespace = _mm256_or_si256(
+            _mm256_or_si256( _mm256_cmpeq_epi8( chunk, space_char ), _mm256_cmpeq_epi8( chunk, tab_char ) ),
+            _mm256_or_si256( _mm256_cmpeq_epi8( chunk, line_char ), _mm256_cmpeq_epi8( chunk, return_char ) ) );
+
+        int const shift = i * 32;
+        masks.quote |= uint64_t( uint32_t( _mm256_movemask_epi8( _mm256_cmpeq_epi8( chunk, quote_char ) ) ) ) << shift;
+        masks.backslash |= uint64_t( uint32_t( _mm256_movemask_epi8( _mm256_cmpeq_epi8( chunk, backslash_char ) ) ) ) << shift;
+        masks.structural |= uint64_t( uint32_t( _mm256_movemask_epi8( structural ) ) ) << shift;
+        masks.whitespace |= uint64_t( uint32_t( _mm256_movemask_epi8( whitespace ) ) ) << shift;
+    }
+    return masks;
+}
+
+static uint64_t prefix_xor( uint64_t bits )
+{
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+template<BlockMasks( *Classify )(char const*)>
+static void scan_blocks( std::string_view const& data, std::vector<size_t>& indices )
+{
+    static constexpr uint64_t even_bits = 0x5555555555555555;
+
+    uint64_t prev_escaped = 0;
+    uint64_t prev_in_string = 0;
+    uint64_t prev_scalar = 0;
+    size_t count = 0;
+
+    char padded[64] = {};
+    for ( size_t offset = 0; offset < data.size(); offset += 64 )
+    {
+        char const* block = data.data() + offset;
+        if ( data.size() - offset < 64 )
+        {
+            memset( padded, ' ', sizeof( padded ) );
+            memcpy( padded, block, data.size() - offset );
+            block = padded;
+        }
+        BlockMasks const masks = Classify( block );
+
+        uint64_t backslash = masks.backslash & ~prev_escaped;
+        uint64_t const follows_escape = (backslash << 1) | prev_escaped;
+        uint64_t const odd_starts = backslash & ~even_bits & ~follows_escape;
+        uint64_t const even_sequences = odd_starts + backslash;
+        prev_escaped = even_sequences < odd_starts;
+        uint64_t const escaped = (even_bits ^ (even_sequences << 1)) & follows_escape;
+
+        uint64_t const quote = masks.quote & ~escaped;
+        uint64_t const in_string = prefix_xor( quote ) ^ prev_in_string;
+        prev_in_string = uint64_t( int64_t( in_string ) >> 63 );
+
+        uint64_t const scalar = ~(masks.structural | masks.whitespace | quote | in_string);
+        uint64_t const scalar_starts = scalar & ~((scalar << 1) | prev_scalar);
+        prev_scalar = scalar >> 63;
+
+        if ( indices.size() < count + 64 )
+            indices.resize( std::max( indices.size() * 2, count + 64 ) );
+
+        size_t* output = indices.data() + count;
+        uint64_t bits = (masks.structural & ~in_string) | quote | scalar_starts;
+        count += std::popcount( bits );
+        for ( ; bits; bits &= bits - 1 )
+            *output++ = offset + std::countr_zero( bits );
+    }
+    indices.resize( count );
+}
+
+kl::json::ScannerLevel kl::json::Scanner::best_level()
+{
+    if ( cpu::has_avx2() )
+        return ScannerLevel::AVX2;
+    if ( cpu::has_sse42() )
+        return ScannerLevel::SSE42;
+    return ScannerLevel::SCALAR;
+}
+
+std::vector<size_t> kl::json::Scanner::scan( std::string_view const& data )
+{
+    static ScannerLevel const level = best_level();
+    return scan( data, level );
+}
+
+std::vector<size_t> kl::json::Scanner::scan( std::string_view const& data, ScannerLevel level )
+{
+    std::vector<size_t> indices;
+    scan( data, level, indices );
+    return indices;
+}
+
+void kl::json::Scanner::scan( std::string_view const& data, ScannerLevel level, std::vector<size_t>& indices )
+{
+    // Only address space is reserved up front, the scan loop grows the size as indices are found.
+    indices.clear();
+    indices.reserve( data.size() / 8 + 64 );
+    switch ( level )
+    {
+    case ScannerLevel::AVX2:
+        scan_blocks<classify_avx2>( data, indices );
+        break;
+
+    case ScannerLevel::SSE42:
+        scan_blocks<classify_sse42>( data, indices );
+        break;
+
+    default:
+        scan_blocks<classify_scalar>( data, indices );
+        break;
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "json/language/standard.h"
+
+
+namespace kl::json
+{
+enum struct ScannerLevel : int32_t
+{
+    SCALAR = 0,
+    SSE42,
+    AVX2,
+};
+}
+
+namespace kl::json
+{
+struct Scanner
+{
+    static ScannerLevel best_level();
+
+    static std::vector<size_t> scan( std::string_view const& data );
+    static std::vector<size_t> scan( std::string_view const& data, ScannerLevel level );
+    static void scan( std::string_view const& data, ScannerLevel level, std::vector<size_t>& indices );
+};
+}
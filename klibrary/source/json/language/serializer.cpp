@@ -0,0 +1,153 @@
+#include "klibrary.h"
+
+
+template<bool Pretty>
+kl::json::Serializer<Pretty>::Serializer( std::string& output )
+    : m_output( output )
+{}
+
+template<bool Pretty>
+kl::json::Serializer<Pretty>::Serializer( Sink const& sink, size_t buffer_size )
+    : m_output( m_buffer ), m_sink( sink ), m_limit( buffer_size )
+{
+    m_buffer.reserve( buffer_size + buffer_size / 4 );
+}
+
+template<bool Pretty>
+kl::json::Serializer<Pretty>::~Serializer()
+{
+    flush();
+}
+
+template<bool Pretty>
+void kl::json::Serializer<Pretty>::write( Container const& container, int depth )
+{
+    write_value( container, Pretty ? depth : -1 );
+    if ( m_sink && m_output.size() >= m_limit )
+        flush();
+}
+
+template<bool Pretty>
+bool kl::json::Serializer<Pretty>::flush()
+{
+    if ( !m_sink || m_output.empty() )
+        return !m_failed;
+
+    if ( !m_failed && !m_sink( m_output ) )
+        m_failed = true;
+    m_output.clear();
+    return !m_failed;
+}
+
+template<bool Pretty>
+bool kl::json::Serializer<Pretty>::failed() const
+{
+    return m_failed;
+}
+
+template<bool Pretty>
+void kl::json::Serializer<Pretty>::write_value( Container const& container, int depth )
+{
+    if ( Literal const* literal = dynamic_cast<Literal const*>(&container) )
+    {
+        if ( bool const* value = std::get_if<bool>( &literal->m_value ) )
+        {
+            m_output.append( *value ? Standard::true_val : Standard::false_val );
+        }
+        else if ( Number const* value = literal->number() )
+        {
+            Lexer::encode_number( *value, m_output );
+        }
+        else if ( std::string const* value = std::get_if<std::string>( &literal->m_value ) )
+        {
+            write_string( *value );
+        }
+        else
+        {
+            m_output.append( Standard::null_val );
+        }
+    }
+    else if ( Object const* object = dynamic_cast<Object const*>(&container) )
+    {
+        m_output.push_back( Standard::object_start );
+        if ( object->empty() )
+        {
+            m_output.push_back( Standard::object_end );
+            return;
+        }
+
+        bool const pretty = Pretty && depth >= 0;
+        m_output.push_back( pretty ? '\n' : ' ' );
+        size_t counter = 0;
+        for ( auto& [key, value] : *object )
+        {
+            if ( pretty )
+                write_indent( depth + 1 );
+            write_string( key );
+            m_output.push_back( Standard::assign );
+            m_output.push_back( ' ' );
+            write_value( *value, pretty ? (depth + 1) : -1 );
+            if ( ++counter != object->size() )
+                m_output.push_back( Standard::splitter );
+            m_output.push_back( pretty ? '\n' : ' ' );
+
+            if ( m_sink && m_output.size() >= m_limit )
+                flush();
+        }
+        if ( pretty )
+            write_indent( depth );
+        m_output.push_back( Standard::object_end );
+    }
+    else if ( Array const* array = dynamic_cast<Array const*>(&container) )
+    {
+        m_output.push_back( Standard::array_start );
+        for ( size_t i = 0; i < array->size(); i++ )
+        {
+            if ( i != 0 )
+            {
+                m_output.push_back( Standard::splitter );
+                m_output.push_back( ' ' );
+            }
+            write_value( *(*array)[i], -1 );
+
+            if ( m_sink && m_output.size() >= m_limit )
+                flush();
+        }
+        m_output.push_back( Standard::array_end );
+    }
+    else
+    {
+        m_output.append( container.decompile( depth ) );
+    }
+}
+
+template<bool Pretty>
+void kl::json::Serializer<Pretty>::write_string( std::string_view const& value )
+{
+    m_output.push_back( Standard::string );
+    Lexer::encode_string( value, m_output );
+    m_output.push_back( Standard::string );
+}
+
+template<bool Pretty>
+void kl::json::Serializer<Pretty>::write_indent( int depth )
+{
+    m_output.append( size_t( depth ) * 2, ' ' );
+}
+
+template struct kl::json::Serializer<false>;
+template struct kl::json::Serializer<true>;
+
+std::string kl::json::to_json( Container const& container )
+{
+    std::string result;
+    Serializer<false>{ result }.write( container );
+    return result;
+}
+
+std::string kl::json::to_pretty_json( Container const& container )
+{
+    std::string result;
+    Serializer<true>{ result }.write( container );
+    return result;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "json/language/lexer.h"
+
+
+namespace kl::json
+{
+struct Container;
+}
+
+namespace kl::json
+{
+template<bool Pretty = false>
+struct Serializer : NoCopy
+{
+    // Sinks return false when they couldn't take all of the data, the serializer stops writing after that.
+    using Sink = std::function<bool( std::string_view const& data )>;
+
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+    Serializer( std::string& output );
+    Serializer( Sink const& sink, size_t buffer_size = DEFAULT_BUFFER_SIZE );
+    ~Serializer();
+
+    void write( Container const& container, int depth = 0 );
+    bool flush();
+    bool failed() const;
+
+private:
+    std::string m_buffer;
+    std::string& m_output;
+    Sink m_sink;
+    size_t m_limit = 0;
+    bool m_failed = false;
+
+    void write_value( Container const& container, int depth );
+    void write_string( std::string_view const& value );
+    void write_indent( int depth );
+};
+}
+
+namespace kl::json
+{
+template<typename T>
+Serializer<>::Sink make_sink( T& target )
+{
+    return [&target]( std::string_view const& data )
+    {
+        if constexpr ( requires { target.send( data.data(), int( data.size() ) ); } )
+        {
+            // Sockets can take less than asked for, the rest goes out in the next send.
+            for ( size_t sent = 0; sent < data.size(); )
+            {
+                int const result = target.send( data.data() + sent, int( std::min<size_t>( data.size() - sent, std::numeric_limits<int>::max() ) ) );
+                if ( result <= 0 )
+                    return false;
+                sent += size_t( result );
+            }
+            return true;
+        }
+        else
+        {
+            return target.write( data.data(), data.size() ) == data.size();
+        }
+    };
+}
+
+std::string to_json( Container const& container );
+std::string to_pretty_json( Container const& container );
+}
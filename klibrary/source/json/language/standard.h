@@ -49,3 +49,12 @@ struct Token
     std::string value;
 };
 }
+
+namespace kl::json
+{
+struct ViewToken
+{
+    TokenType type;
+    std::string_view value;
+};
+}
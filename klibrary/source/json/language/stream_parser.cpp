@@ -0,0 +1,247 @@
+#include "klibrary.h"
+
+
+kl::json::StreamParser::StreamParser( Source const& source, uint64_t chunk_size )
+    : m_source( source )
+{
+    m_buffer.resize( std::max<uint64_t>( chunk_size, 16 ) );
+}
+
+kl::json::StreamParser::StreamParser( File const& file, uint64_t chunk_size )
+    : StreamParser( [&file]( char* buffer, uint64_t size ) { return file.read( buffer, size ); }, chunk_size )
+{}
+
+kl::json::StreamEvent kl::json::StreamParser::next_event()
+{
+    while ( !m_done )
+    {
+        StreamEvent event = next_token();
+        bool const key_expected = !m_stack.empty() && m_stack.back().object && m_stack.back().expect_key;
+        switch ( event.type )
+        {
+        case EventType::END:
+            return event;
+
+        case EventType::OBJECT_START:
+        case EventType::ARRAY_START:
+            if ( key_expected )
+            {
+                skip_container();
+                continue;
+            }
+            m_stack.push_back( { event.type == EventType::OBJECT_START, true } );
+            return event;
+
+        case EventType::OBJECT_END:
+        case EventType::ARRAY_END:
+            if ( m_stack.empty() )
+                continue;
+            event.type = m_stack.back().object ? EventType::OBJECT_END : EventType::ARRAY_END;
+            m_stack.pop_back();
+            end_value();
+            return event;
+
+        case EventType::LIT_STRING:
+            if ( key_expected )
+            {
+                m_stack.back().expect_key = false;
+                event.type = EventType::KEY;
+                return event;
+            }
+            end_value();
+            return event;
+
+        default:
+            if ( key_expected )
+                continue;
+            end_value();
+            return event;
+        }
+    }
+    return {};
+}
+
+void kl::json::StreamParser::skip_value()
+{
+    StreamEvent const event = next_event();
+    if ( event.type != EventType::OBJECT_START && event.type != EventType::ARRAY_START )
+        return;
+
+    size_t const target = m_stack.size() - 1;
+    while ( m_stack.size() > target && next_event().type != EventType::END );
+}
+
+size_t kl::json::StreamParser::depth() const
+{
+    return m_stack.size();
+}
+
+bool kl::json::StreamParser::refill()
+{
+    if ( m_eof )
+        return false;
+
+    if ( m_position > 0 )
+    {
+        memmove( m_buffer.data(), m_buffer.data() + m_position, m_end - m_position );
+        m_end -= m_position;
+        m_position = 0;
+    }
+    if ( m_end == m_buffer.size() )
+        m_buffer.resize( m_buffer.size() * 2 );
+
+    uint64_t const read = m_source( m_buffer.data() + m_end, m_buffer.size() - m_end );
+    if ( read == 0 )
+    {
+        m_eof = true;
+        return false;
+    }
+    m_end += read;
+    return true;
+}
+
+kl::json::StreamEvent kl::json::StreamParser::next_token()
+{
+    // refill() moves and can reallocate the buffer even when it hits the end of the input, so every
+    // branch that refills starts over and takes the view again.
+    while ( true )
+    {
+        if ( m_position >= m_end && !refill() )
+            return {};
+
+        std::string_view const data{ m_buffer.data(), m_end };
+        switch ( data[m_position] )
+        {
+        case Standard::object_start:
+            m_position += 1;
+            return { EventType::OBJECT_START };
+
+        case Standard::object_end:
+            m_position += 1;
+            return { EventType::OBJECT_END };
+
+        case Standard::array_start:
+            m_position += 1;
+            return { EventType::ARRAY_START };
+
+        case Standard::array_end:
+            m_position += 1;
+            return { EventType::ARRAY_END };
+
+        case Standard::string:
+        {
+            size_t end = data.find_first_of( "\"\\", m_position + 1 );
+            bool escaped = false;
+            while ( end != std::string_view::npos && data[end] == Standard::escaping )
+            {
+                escaped = true;
+                end = data.find_first_of( "\"\\", end + 2 );
+            }
+            if ( end == std::string_view::npos )
+            {
+                if ( !m_eof )
+                {
+                    refill();
+                    continue;
+                }
+                end = data.size();
+            }
+
+            std::string_view value = data.substr( m_position + 1, end - m_position - 1 );
+            m_position = std::min( end + 1, data.size() );
+            if ( escaped )
+            {
+                m_scratch.clear();
+                Lexer::decode_string( value, m_scratch );
+                value = m_scratch;
+            }
+            return { EventType::LIT_STRING, value };
+        }
+
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+        {
+            size_t end = m_position;
+            std::string_view const value = Parser::read_number( data, end );
+            if ( end + 1 == data.size() && !m_eof )
+            {
+                refill();
+                continue;
+            }
+
+            m_position = end + 1;
+            return { EventType::LIT_NUMBER, value };
+        }
+
+        case Standard::true_val.front():
+        case Standard::false_val.front():
+        case Standard::null_val.front():
+        {
+            if ( (data.size() - m_position) < Standard::false_val.size() && !m_eof )
+            {
+                refill();
+                continue;
+            }
+
+            size_t end = m_position;
+            std::optional<TokenType> const type = Parser::read_keyword( data, end );
+            m_position = end + 1;
+            if ( type == TokenType::VAL_NULL )
+                return { EventType::VAL_NULL };
+            if ( type == TokenType::VAL_FALSE )
+                return { EventType::VAL_FALSE };
+            if ( type == TokenType::VAL_TRUE )
+                return { EventType::VAL_TRUE };
+            break;
+        }
+
+        default:
+            m_position += 1;
+            break;
+        }
+    }
+}
+
+void kl::json::StreamParser::skip_container()
+{
+    int depth = 1;
+    while ( depth > 0 )
+    {
+        switch ( next_token().type )
+        {
+        case EventType::END:
+            return;
+
+        case EventType::OBJECT_START:
+        case EventType::ARRAY_START:
+            depth += 1;
+            break;
+
+        case EventType::OBJECT_END:
+        case EventType::ARRAY_END:
+            depth -= 1;
+            break;
+        }
+    }
+}
+
+void kl::json::StreamParser::end_value()
+{
+    if ( m_stack.empty() )
+    {
+        m_done = true;
+    }
+    else
+    {
+        m_stack.back().expect_key = true;
+    }
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "json/language/parser.h"
+#include "memory/files/file.h"
+
+
+namespace kl::json
+{
+enum struct EventType : int32_t
+{
+    END = 0,
+    OBJECT_START,
+    OBJECT_END,
+    ARRAY_START,
+    ARRAY_END,
+    KEY,
+    VAL_NULL,
+    VAL_FALSE,
+    VAL_TRUE,
+    LIT_NUMBER,
+    LIT_STRING,
+};
+}
+
+namespace kl::json
+{
+struct StreamEvent
+{
+    EventType type = EventType::END;
+    std::string_view value;
+};
+}
+
+namespace kl::json
+{
+// Event values are only valid until the next call on the parser.
+struct StreamParser : NoCopy
+{
+    using Source = std::function<uint64_t( char* buffer, uint64_t size )>;
+
+    static constexpr uint64_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+    StreamParser( Source const& source, uint64_t chunk_size = DEFAULT_CHUNK_SIZE );
+    StreamParser( File const& file, uint64_t chunk_size = DEFAULT_CHUNK_SIZE );
+
+    StreamEvent next_event();
+    void skip_value();
+    size_t depth() const;
+
+    template<typename H>
+    static bool parse_events( Source const& source, H& handler, uint64_t chunk_size = DEFAULT_CHUNK_SIZE )
+    {
+        StreamParser parser{ source, chunk_size };
+        while ( true )
+        {
+            StreamEvent const event = parser.next_event();
+            bool result = true;
+            switch ( event.type )
+            {
+            case EventType::END:
+                return parser.m_done;
+
+            case EventType::OBJECT_START:
+                result = handler.on_object_start();
+                break;
+
+            case EventType::OBJECT_END:
+                result = handler.on_object_end();
+                break;
+
+            case EventType::ARRAY_START:
+                result = handler.on_array_start();
+                break;
+
+            case EventType::ARRAY_END:
+                result = handler.on_array_end();
+                break;
+
+            case EventType::KEY:
+                result = handler.on_key( event.value );
+                break;
+
+            case EventType::VAL_NULL:
+                result = handler.on_null();
+                break;
+
+            case EventType::VAL_FALSE:
+            case EventType::VAL_TRUE:
+                result = handler.on_bool( event.type == EventType::VAL_TRUE );
+                break;
+
+            case EventType::LIT_NUMBER:
+                result = handler.on_number( event.value );
+                break;
+
+            case EventType::LIT_STRING:
+                result = handler.on_string( event.value );
+                break;
+            }
+            if ( !result )
+                return false;
+        }
+    }
+
+private:
+    struct Frame
+    {
+        bool object = false;
+        bool expect_key = false;
+    };
+
+    Source m_source;
+    std::string m_buffer;
+    std::string m_scratch;
+    size_t m_position = 0;
+    size_t m_end = 0;
+    bool m_eof = false;
+    bool m_done = false;
+    std::vector<Frame> m_stack;
+
+    bool refill();
+    StreamEvent next_token();
+    void skip_container();
+    void end_value();
+};
+}
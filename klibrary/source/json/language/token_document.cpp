@@ -0,0 +1,118 @@
+#include "klibrary.h"
+
+
+kl::json::TokenDocument::TokenDocument()
+{}
+
+kl::json::TokenDocument::TokenDocument( std::string_view const& data )
+{
+    parse( data );
+}
+
+void kl::json::TokenDocument::parse( std::string_view const& data )
+{
+    m_source = data;
+    m_decoded.clear();
+    m_tokens.clear();
+
+    Scanner::scan( data, Scanner::best_level(), m_indices );
+    m_tokens.reserve( m_indices.size() );
+    for ( size_t k = 0; k < m_indices.size(); k++ )
+    {
+        size_t i = m_indices[k];
+        switch ( data[i] )
+        {
+        case Standard::object_start:
+            m_tokens.push_back( { TokenType::OBJECT_START } );
+            break;
+
+        case Standard::object_end:
+            m_tokens.push_back( { TokenType::OBJECT_END } );
+            break;
+
+        case Standard::array_start:
+            m_tokens.push_back( { TokenType::ARRAY_START } );
+            break;
+
+        case Standard::array_end:
+            m_tokens.push_back( { TokenType::ARRAY_END } );
+            break;
+
+        case Standard::string:
+        {
+            size_t const end = (k + 1) < m_indices.size() ? m_indices[++k] : data.size();
+            std::string_view const content = data.substr( i + 1, end - i - 1 );
+            if ( content.find( Standard::escaping ) == std::string_view::npos )
+            {
+                m_tokens.push_back( { TokenType::LIT_STRING, content } );
+            }
+            else
+            {
+                m_tokens.push_back( { TokenType::LIT_STRING, decode( content, data.size() - i ) } );
+            }
+            break;
+        }
+
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            m_tokens.push_back( { TokenType::LIT_NUMBER, Parser::read_number( data, i ) } );
+            break;
+
+        case Standard::true_val.front():
+        case Standard::false_val.front():
+        case Standard::null_val.front():
+            if ( std::optional<TokenType> type = Parser::read_keyword( data, i ) )
+                m_tokens.push_back( { type.value() } );
+            break;
+        }
+    }
+}
+
+std::string_view kl::json::TokenDocument::source() const
+{
+    return m_source;
+}
+
+std::vector<kl::json::ViewToken> const& kl::json::TokenDocument::tokens() const
+{
+    return m_tokens;
+}
+
+size_t kl::json::TokenDocument::size() const
+{
+    return m_tokens.size();
+}
+
+kl::json::ViewToken const& kl::json::TokenDocument::operator[]( size_t index ) const
+{
+    return m_tokens[index];
+}
+
+std::vector<kl::json::ViewToken>::const_iterator kl::json::TokenDocument::begin() const
+{
+    return m_tokens.begin();
+}
+
+std::vector<kl::json::ViewToken>::const_iterator kl::json::TokenDocument::end() const
+{
+    return m_tokens.end();
+}
+
+std::string_view kl::json::TokenDocument::decode( std::string_view const& content, size_t remaining )
+{
+    if ( m_decoded.empty() )
+        m_decoded.reserve( remaining );
+
+    size_t const first = m_decoded.size();
+    Lexer::decode_string( content, m_decoded );
+    return std::string_view{ m_decoded }.substr( first );
+}
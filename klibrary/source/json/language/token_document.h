@@ -0,0 +1,34 @@
+#pragma once
+
+#include "json/language/lexer.h"
+
+
+namespace kl::json
+{
+// Token values view either the source data or the document's decoded buffer,
+// so they stay valid only while both the source and the document are alive.
+struct TokenDocument : NoCopy
+{
+    TokenDocument();
+    TokenDocument( std::string_view const& data );
+
+    void parse( std::string_view const& data );
+
+    std::string_view source() const;
+    std::vector<ViewToken> const& tokens() const;
+
+    size_t size() const;
+    ViewToken const& operator[]( size_t index ) const;
+
+    std::vector<ViewToken>::const_iterator begin() const;
+    std::vector<ViewToken>::const_iterator end() const;
+
+private:
+    std::string_view m_source;
+    std::string m_decoded;
+    std::vector<size_t> m_indices;
+    std::vector<ViewToken> m_tokens;
+
+    std::string_view decode( std::string_view const& content, size_t remaining );
+};
+}
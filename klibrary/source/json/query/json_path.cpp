@@ -0,0 +1,540 @@
+#include "klibrary.h"
+
+
+namespace kl::json
+{
+static bool is_valid( Container const* node )
+{
+    return node;
+}
+
+static bool is_valid( LazyView const& node )
+{
+    return (bool) node;
+}
+
+static bool is_array( Container const* node )
+{
+    return dynamic_cast<Array const*>(node);
+}
+
+static bool is_array( LazyView const& node )
+{
+    return node.type() == NodeType::ARRAY;
+}
+
+static bool is_null( Container const* node )
+{
+    return dynamic_cast<Literal const*>(node) && !node->get_bool() && !node->get_double() && !node->get_string();
+}
+
+static bool is_null( LazyView const& node )
+{
+    return node.type() == NodeType::VAL_NULL;
+}
+
+static Container const& value_of( Container const* node )
+{
+    return *node;
+}
+
+static LazyView const& value_of( LazyView const& node )
+{
+    return node;
+}
+
+template<typename F>
+static void for_each_child( Container const* node, F const& func )
+{
+    if ( Object const* object = dynamic_cast<Object const*>(node) )
+    {
+        for ( auto& [key, value] : *object )
+        {
+            if ( value )
+                func( &value );
+        }
+    }
+    else if ( Array const* array = dynamic_cast<Array const*>(node) )
+    {
+        for ( auto& value : *array )
+        {
+            if ( value )
+                func( &value );
+        }
+    }
+}
+
+template<typename F>
+static void for_each_child( LazyView const& node, F const& func )
+{
+    node.for_each_child( [&]( LazyView const& key, LazyView const& value )
+    {
+        func( value );
+        return true;
+    } );
+}
+
+static Container const* find_child( Container const* node, std::string_view const& name )
+{
+    if ( Object const* object = dynamic_cast<Object const*>(node) )
+    {
+        auto it = object->find( name );
+        if ( it != object->end() )
+            return &it->second;
+    }
+    return nullptr;
+}
+
+static LazyView find_child( LazyView const& node, std::string_view const& name )
+{
+    return node[name];
+}
+
+template<typename N>
+static void collect_descendants( N const& node, std::vector<N>& output )
+{
+    output.push_back( node );
+    for_each_child( node, [&]( N const& child )
+    {
+        collect_descendants( child, output );
+    } );
+}
+
+template<typename N>
+static bool filter_matches( PathStep const& step, N node )
+{
+    for ( auto& name : step.filter_path )
+    {
+        node = find_child( node, name );
+        if ( !is_valid( node ) )
+            return false;
+    }
+    if ( step.filter_op == FilterOp::EXISTS )
+        return true;
+
+    std::optional<int> order;
+    if ( double const* value = std::get_if<double>( &step.filter_value ) )
+    {
+        if ( auto number = value_of( node ).get_double() )
+            order = int( number.value() > *value ) - int( number.value() < *value );
+    }
+    else if ( std::string const* value = std::get_if<std::string>( &step.filter_value ) )
+    {
+        if ( auto text = value_of( node ).get_string() )
+            order = std::clamp( text.value().compare( *value ), -1, 1 );
+    }
+    else if ( bool const* value = std::get_if<bool>( &step.filter_value ) )
+    {
+        if ( auto flag = value_of( node ).get_bool() )
+            order = int( flag.value() ) - int( *value );
+    }
+    else if ( is_null( node ) )
+    {
+        order = 0;
+    }
+
+    if ( !order )
+        return step.filter_op == FilterOp::NOT_EQUAL;
+
+    switch ( step.filter_op )
+    {
+    case FilterOp::EQUAL:
+        return order.value() == 0;
+
+    case FilterOp::NOT_EQUAL:
+        return order.value() != 0;
+
+    case FilterOp::LESS:
+        return order.value() < 0;
+
+    case FilterOp::LESS_EQUAL:
+        return order.value() <= 0;
+
+    case FilterOp::GREATER:
+        return order.value() > 0;
+
+    case FilterOp::GREATER_EQUAL:
+        return order.value() >= 0;
+    }
+    return false;
+}
+
+template<typename N>
+static void select_range( PathStep const& step, std::vector<N> const& elements, std::vector<N>& output )
+{
+    int64_t const size = int64_t( elements.size() );
+    auto normalize = [size]( int64_t index )
+    {
+        return index < 0 ? index + size : index;
+    };
+
+    if ( step.type == PathStepType::INDEX )
+    {
+        int64_t const index = normalize( step.start.value_or( 0 ) );
+        if ( index >= 0 && index < size )
+            output.push_back( elements[index] );
+        return;
+    }
+
+    if ( step.step > 0 )
+    {
+        int64_t const first = step.start ? std::clamp<int64_t>( normalize( step.start.value() ), 0, size ) : 0;
+        int64_t const last = step.end ? std::clamp<int64_t>( normalize( step.end.value() ), 0, size ) : size;
+        for ( int64_t i = first; i < last; i += step.step )
+            output.push_back( elements[i] );
+    }
+    else if ( step.step < 0 )
+    {
+        int64_t const first = step.start ? std::clamp<int64_t>( normalize( step.start.value() ), -1, size - 1 ) : (size - 1);
+        int64_t const last = step.end ? std::clamp<int64_t>( normalize( step.end.value() ), -1, size - 1 ) : -1;
+        for ( int64_t i = first; i > last; i += step.step )
+            output.push_back( elements[i] );
+    }
+}
+
+template<typename N>
+static void apply_step( PathStep const& step, N const& node, std::vector<N>& output, std::vector<N>& elements )
+{
+    switch ( step.type )
+    {
+    case PathStepType::NAME:
+    {
+        N const child = find_child( node, step.name );
+        if ( is_valid( child ) )
+            output.push_back( child );
+        break;
+    }
+
+    case PathStepType::WILDCARD:
+        for_each_child( node, [&]( N const& child )
+        {
+            output.push_back( child );
+        } );
+        break;
+
+    case PathStepType::DESCEND:
+        collect_descendants( node, output );
+        break;
+
+    case PathStepType::FILTER:
+        for_each_child( node, [&]( N const& child )
+        {
+            if ( filter_matches( step, child ) )
+                output.push_back( child );
+        } );
+        break;
+
+    case PathStepType::INDEX:
+    case PathStepType::SLICE:
+        if ( !is_array( node ) )
+            break;
+
+        elements.clear();
+        for_each_child( node, [&]( N const& child )
+        {
+            elements.push_back( child );
+        } );
+        select_range( step, elements, output );
+        break;
+    }
+}
+
+static size_t skip_spaces( std::string_view const& path, size_t i )
+{
+    while ( i < path.size() && path[i] == ' ' )
+        i += 1;
+    return i;
+}
+
+static bool read_quoted( std::string_view const& path, size_t& i, std::string& result )
+{
+    char const quote = path[i];
+    result.clear();
+    for ( i += 1; i < path.size(); i++ )
+    {
+        if ( path[i] == quote )
+        {
+            i += 1;
+            return true;
+        }
+        if ( path[i] == Standard::escaping && (i + 1) < path.size() )
+            i += 1;
+        result.push_back( path[i] );
+    }
+    return false;
+}
+
+static std::optional<int64_t> read_integer( std::string_view const& path, size_t& i )
+{
+    int64_t result = 0;
+    auto [last, error] = std::from_chars( path.data() + i, path.data() + path.size(), result );
+    if ( error != std::errc{} )
+        return std::nullopt;
+
+    i = last - path.data();
+    return { result };
+}
+}
+
+kl::json::JsonPath::JsonPath()
+{}
+
+kl::json::JsonPath::JsonPath( std::string_view const& path )
+{
+    compile( path );
+}
+
+bool kl::json::JsonPath::compile( std::string_view const& path )
+{
+    m_steps.clear();
+    m_valid = false;
+
+    size_t i = (!path.empty() && path.front() == '$') ? 1 : 0;
+    while ( i < path.size() )
+    {
+        if ( path[i] == '[' )
+        {
+            if ( !compile_bracket( path, i ) )
+            {
+                m_steps.clear();
+                return false;
+            }
+            continue;
+        }
+        if ( path[i] != '.' )
+        {
+            m_steps.clear();
+            return false;
+        }
+
+        i += 1;
+        if ( i < path.size() && path[i] == '.' )
+        {
+            m_steps.push_back( { PathStepType::DESCEND } );
+            i += 1;
+            if ( i < path.size() && path[i] == '[' )
+                continue;
+        }
+        if ( i < path.size() && path[i] == '*' )
+        {
+            m_steps.push_back( { PathStepType::WILDCARD } );
+            i += 1;
+            continue;
+        }
+
+        size_t const first = i;
+        while ( i < path.size() && path[i] != '.' && path[i] != '[' )
+            i += 1;
+        if ( i == first )
+        {
+            m_steps.clear();
+            return false;
+        }
+        m_steps.push_back( { PathStepType::NAME, std::string{ path.substr( first, i - first ) } } );
+    }
+    m_valid = true;
+    return true;
+}
+
+kl::json::JsonPath::operator bool() const
+{
+    return m_valid;
+}
+
+std::vector<kl::json::PathStep> const& kl::json::JsonPath::steps() const
+{
+    return m_steps;
+}
+
+void kl::json::JsonPath::select( Container const& root, std::vector<Container const*>& results ) const
+{
+    run<Container const*>( &root, results );
+}
+
+void kl::json::JsonPath::select( LazyView const& root, std::vector<LazyView>& results ) const
+{
+    run<LazyView>( root, results );
+}
+
+std::vector<kl::json::Container const*> kl::json::JsonPath::select( Container const& root ) const
+{
+    std::vector<Container const*> results;
+    select( root, results );
+    return results;
+}
+
+std::vector<kl::json::LazyView> kl::json::JsonPath::select( LazyView const& root ) const
+{
+    std::vector<LazyView> results;
+    select( root, results );
+    return results;
+}
+
+bool kl::json::JsonPath::compile_bracket( std::string_view const& path, size_t& i )
+{
+    PathStep step{};
+    i = skip_spaces( path, i + 1 );
+    if ( i >= path.size() )
+        return false;
+
+    if ( path[i] == '*' )
+    {
+        step.type = PathStepType::WILDCARD;
+        i += 1;
+    }
+    else if ( path[i] == '\'' || path[i] == Standard::string )
+    {
+        step.type = PathStepType::NAME;
+        if ( !read_quoted( path, i, step.name ) )
+            return false;
+    }
+    else if ( path[i] == '?' )
+    {
+        step.type = PathStepType::FILTER;
+        if ( !compile_filter( path, i, step ) )
+            return false;
+    }
+    else
+    {
+        step.type = PathStepType::INDEX;
+        step.start = read_integer( path, i );
+        i = skip_spaces( path, i );
+        if ( i < path.size() && path[i] == ':' )
+        {
+            step.type = PathStepType::SLICE;
+            i = skip_spaces( path, i + 1 );
+            step.end = read_integer( path, i );
+            i = skip_spaces( path, i );
+            if ( i < path.size() && path[i] == ':' )
+            {
+                i = skip_spaces( path, i + 1 );
+                step.step = read_integer( path, i ).value_or( 1 );
+            }
+        }
+        else if ( !step.start )
+        {
+            return false;
+        }
+    }
+
+    i = skip_spaces( path, i );
+    if ( i >= path.size() || path[i] != ']' )
+        return false;
+
+    i += 1;
+    m_steps.push_back( std::move( step ) );
+    return true;
+}
+
+bool kl::json::JsonPath::compile_filter( std::string_view const& path, size_t& i, PathStep& step )
+{
+    i = skip_spaces( path, i + 1 );
+    if ( i >= path.size() || path[i] != '(' )
+        return false;
+    i = skip_spaces( path, i + 1 );
+    if ( i >= path.size() || path[i] != '@' )
+        return false;
+
+    for ( i += 1; i < path.size() && (path[i] == '.' || path[i] == '['); )
+    {
+        std::string& name = step.filter_path.emplace_back();
+        if ( path[i] == '.' )
+        {
+            size_t const first = ++i;
+            i = path.find_first_of( " .[)=!<>", i );
+            if ( i == std::string_view::npos )
+                return false;
+            name = path.substr( first, i - first );
+            continue;
+        }
+        i = skip_spaces( path, i + 1 );
+        if ( i >= path.size() || (path[i] != '\'' && path[i] != Standard::string) || !read_quoted( path, i, name ) )
+            return false;
+        i = skip_spaces( path, i );
+        if ( i >= path.size() || path[i] != ']' )
+            return false;
+        i += 1;
+    }
+
+    static constexpr std::pair<std::string_view, FilterOp> operators[] = {
+        { "==", FilterOp::EQUAL },
+        { "!=", FilterOp::NOT_EQUAL },
+        { "<=", FilterOp::LESS_EQUAL },
+        { ">=", FilterOp::GREATER_EQUAL },
+        { "<", FilterOp::LESS },
+        { ">", FilterOp::GREATER },
+    };
+    i = skip_spaces( path, i );
+    for ( auto& [text, op] : operators )
+    {
+        if ( path.substr( i, text.size() ) == text )
+        {
+            step.filter_op = op;
+            i = skip_spaces( path, i + text.size() );
+            break;
+        }
+    }
+
+    if ( step.filter_op != FilterOp::EXISTS )
+    {
+        if ( i >= path.size() )
+            return false;
+
+        if ( path[i] == '\'' || path[i] == Standard::string )
+        {
+            if ( !read_quoted( path, i, step.filter_value.emplace<std::string>() ) )
+                return false;
+        }
+        else if ( path.substr( i, Standard::true_val.size() ) == Standard::true_val )
+        {
+            step.filter_value = true;
+            i += Standard::true_val.size();
+        }
+        else if ( path.substr( i, Standard::false_val.size() ) == Standard::false_val )
+        {
+            step.filter_value = false;
+            i += Standard::false_val.size();
+        }
+        else if ( path.substr( i, Standard::null_val.size() ) == Standard::null_val )
+        {
+            step.filter_value = nullptr;
+            i += Standard::null_val.size();
+        }
+        else
+        {
+            size_t const first = i;
+            i = std::min( path.find_first_of( " )", i ), path.size() );
+            std::optional<Number> const number = Number::parse( path.substr( first, i - first ) );
+            if ( !number )
+                return false;
+            step.filter_value = number->as<double>();
+        }
+    }
+
+    i = skip_spaces( path, i );
+    if ( i >= path.size() || path[i] != ')' )
+        return false;
+    i += 1;
+    return true;
+}
+
+template<typename N>
+void kl::json::JsonPath::run( N const& root, std::vector<N>& results ) const
+{
+    if ( !m_valid )
+        return;
+
+    std::vector<N> current{ root };
+    std::vector<N> next;
+    std::vector<N> elements;
+    for ( auto& step : m_steps )
+    {
+        next.clear();
+        for ( auto& node : current )
+            apply_step( step, node, next, elements );
+        current.swap( next );
+        if ( current.empty() )
+            return;
+    }
+    results.insert( results.end(), current.begin(), current.end() );
+}
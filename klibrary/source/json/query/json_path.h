@@ -0,0 +1,75 @@
+#pragma once
+
+#include "json/document/lazy_document.h"
+
+
+namespace kl::json
+{
+enum struct PathStepType : uint8_t
+{
+    NAME = 0,
+    INDEX,
+    SLICE,
+    WILDCARD,
+    DESCEND,
+    FILTER,
+};
+
+enum struct FilterOp : uint8_t
+{
+    EXISTS = 0,
+    EQUAL,
+    NOT_EQUAL,
+    LESS,
+    LESS_EQUAL,
+    GREATER,
+    GREATER_EQUAL,
+};
+}
+
+namespace kl::json
+{
+struct PathStep
+{
+    PathStepType type = PathStepType::NAME;
+    std::string name;
+    std::optional<int64_t> start;
+    std::optional<int64_t> end;
+    int64_t step = 1;
+
+    std::vector<std::string> filter_path;
+    FilterOp filter_op = FilterOp::EXISTS;
+    std::variant<std::nullptr_t, bool, double, std::string> filter_value;
+};
+}
+
+namespace kl::json
+{
+// Supports $, .name, ['name'], * wildcards, .. descent, [index], [start:end:step]
+// and [?(@.field op value)] filters with numbers, strings, booleans and null.
+struct JsonPath
+{
+    JsonPath();
+    JsonPath( std::string_view const& path );
+
+    bool compile( std::string_view const& path );
+    explicit operator bool() const;
+    std::vector<PathStep> const& steps() const;
+
+    void select( Container const& root, std::vector<Container const*>& results ) const;
+    void select( LazyView const& root, std::vector<LazyView>& results ) const;
+
+    std::vector<Container const*> select( Container const& root ) const;
+    std::vector<LazyView> select( LazyView const& root ) const;
+
+private:
+    std::vector<PathStep> m_steps;
+    bool m_valid = false;
+
+    bool compile_bracket( std::string_view const& path, size_t& i );
+    bool compile_filter( std::string_view const& path, size_t& i, PathStep& step );
+
+    template<typename N>
+    void run( N const& root, std::vector<N>& results ) const;
+};
+}
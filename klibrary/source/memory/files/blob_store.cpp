@@ -0,0 +1,472 @@
+#include "klibrary.h"
+
+
+static constexpr uint32_t INDEX_MAGIC = 0x53424C4B;
+static constexpr uint32_t INDEX_VERSION = 1;
+static constexpr uint64_t INITIAL_SLOT_COUNT = 1024;
+static constexpr uint64_t MIN_PACK_SIZE = 1024 * 1024;
+
+static constexpr std::array<uint64_t, 256> gear_table = []
+{
+    std::array<uint64_t, 256> result = {};
+    uint64_t state = 0;
+    for ( auto& value : result )
+    {
+        state += 0x9E3779B97F4A7C15;
+        uint64_t mixed = state;
+        mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9;
+        mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EB;
+        value = mixed ^ (mixed >> 31);
+    }
+    return result;
+}();
+
+static uint64_t slot_of( kl::Hash const& hash, uint64_t slot_count )
+{
+    uint64_t key = 0;
+    memcpy( &key, hash.buffer, sizeof( key ) );
+    return key & (slot_count - 1);
+}
+
+// collect() renames index.tmp to index.new once the new pack and index are both on disk, that rename is
+// the commit point. The remaining renames are redone here, temporary files without index.new are dropped.
+static bool finish_swap( std::string const& directory )
+{
+    std::string const committed_path = directory + "/index.new";
+    std::string const packed_path = directory + "/pack.tmp";
+    std::error_code error;
+    if ( !std::filesystem::exists( committed_path, error ) )
+    {
+        std::filesystem::remove( packed_path, error );
+        std::filesystem::remove( directory + "/index.tmp", error );
+        return true;
+    }
+
+    if ( std::filesystem::exists( packed_path, error ) )
+    {
+        std::filesystem::rename( packed_path, directory + "/pack.bin", error );
+        if ( error )
+            return false;
+    }
+    std::filesystem::rename( committed_path, directory + "/index.bin", error );
+    return !error;
+}
+
+std::string kl::BlobView::read() const
+{
+    std::string result;
+    result.reserve( byte_size );
+    for ( auto& chunk : chunks )
+        result.append( reinterpret_cast<char const*>(chunk.data()), chunk.size() );
+    return result;
+}
+
+kl::BlobStore::BlobStore()
+{}
+
+kl::BlobStore::BlobStore( std::string_view const& directory )
+{
+    open( directory );
+}
+
+kl::BlobStore::~BlobStore()
+{
+    close();
+}
+
+kl::BlobStore::operator bool() const
+{
+    return m_index && m_pack;
+}
+
+bool kl::BlobStore::open( std::string_view const& directory )
+{
+    close();
+    std::error_code error;
+    std::filesystem::create_directories( directory, error );
+    m_directory = directory;
+    if ( !verify( finish_swap( m_directory ), "Blob store \"", m_directory, "\" could not finish an interrupted collect" ) )
+        return false;
+
+    std::string const index_path = m_directory + "/index.bin";
+    if ( std::filesystem::exists( index_path, error ) )
+    {
+        bool const valid = m_index.open( index_path, true ) && m_index.size() >= sizeof( Header )
+            && header().magic == INDEX_MAGIC && header().version == INDEX_VERSION
+            && m_index.size() == sizeof( Header ) + header().slot_count * sizeof( BlobRecord );
+        if ( !verify( valid, "Blob store index \"", index_path, "\" is not valid" ) )
+        {
+            close();
+            return false;
+        }
+    }
+    else if ( !create_index( INITIAL_SLOT_COUNT, {}, 0 ) )
+    {
+        close();
+        return false;
+    }
+
+    std::string const pack_path = m_directory + "/pack.bin";
+    if ( !m_pack.open( pack_path, true ) )
+    {
+        close();
+        return false;
+    }
+    if ( !verify( header().pack_size <= m_pack.size(), "Blob store pack \"", pack_path, "\" is shorter than its index" ) )
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void kl::BlobStore::close()
+{
+    // The pack grows ahead of its content, the unused tail is trimmed on close.
+    if ( *this && header().pack_size > 0 && header().pack_size < m_pack.size() )
+        m_pack.open( m_directory + "/pack.bin", true, header().pack_size );
+
+    flush();
+    m_pack.close();
+    m_index.close();
+}
+
+bool kl::BlobStore::flush() const
+{
+    return m_pack.flush() && m_index.flush();
+}
+
+std::optional<kl::Hash> kl::BlobStore::put( void const* data, uint64_t byte_size )
+{
+    if ( !*this )
+        return std::nullopt;
+
+    Hash const hash = kl::hash( data, byte_size );
+    if ( BlobRecord* blob = find( hash, BlobRecordType::BLOB ) )
+    {
+        if ( blob->references++ == 0 )
+            reference_chunks( *blob, 1 );
+        return hash;
+    }
+
+    std::vector<std::string_view> chunks;
+    char const* bytes = reinterpret_cast<char const*>(data);
+    for ( uint64_t size : split_chunks( data, byte_size ) )
+    {
+        chunks.emplace_back( bytes, size );
+        bytes += size;
+    }
+    std::vector<Hash> const chunk_hashes = hash_batch( chunks );
+
+    // Reserving the worst case up front means a full disk fails before any reference changes.
+    if ( !reserve( byte_size + chunk_hashes.size() * sizeof( Hash ) ) )
+        return std::nullopt;
+
+    for ( size_t i = 0; i < chunks.size(); i++ )
+    {
+        if ( BlobRecord* chunk = find( chunk_hashes[i], BlobRecordType::CHUNK ) )
+        {
+            chunk->references += 1;
+            continue;
+        }
+        uint64_t const offset = append( chunks[i].data(), chunks[i].size() );
+        if ( !insert( { chunk_hashes[i], offset, chunks[i].size(), 0, 1, BlobRecordType::CHUNK } ) )
+            return std::nullopt;
+    }
+
+    uint64_t const offset = append( chunk_hashes.data(), chunk_hashes.size() * sizeof( Hash ) );
+    if ( !insert( { hash, offset, byte_size, uint32_t( chunk_hashes.size() ), 1, BlobRecordType::BLOB } ) )
+        return std::nullopt;
+    return hash;
+}
+
+std::optional<kl::Hash> kl::BlobStore::put( std::string_view const& data )
+{
+    return put( data.data(), data.size() );
+}
+
+bool kl::BlobStore::contains( Hash const& hash ) const
+{
+    BlobRecord const* blob = find( hash, BlobRecordType::BLOB );
+    return blob && blob->references > 0;
+}
+
+std::optional<kl::BlobView> kl::BlobStore::get( Hash const& hash ) const
+{
+    BlobRecord const* blob = find( hash, BlobRecordType::BLOB );
+    if ( !blob || blob->references == 0 )
+        return std::nullopt;
+
+    BlobView view{ blob->byte_size };
+    view.chunks.reserve( blob->chunk_count );
+    for ( uint32_t i = 0; i < blob->chunk_count; i++ )
+    {
+        Hash chunk_hash;
+        memcpy( chunk_hash.buffer, m_pack.data() + blob->offset + i * sizeof( Hash ), sizeof( Hash ) );
+        BlobRecord const* chunk = find( chunk_hash, BlobRecordType::CHUNK );
+        if ( !chunk )
+            return std::nullopt;
+        view.chunks.emplace_back( m_pack.data() + chunk->offset, chunk->byte_size );
+    }
+    return view;
+}
+
+std::optional<std::string> kl::BlobStore::read( Hash const& hash ) const
+{
+    std::optional<BlobView> const view = get( hash );
+    if ( !view )
+        return std::nullopt;
+    return view->read();
+}
+
+bool kl::BlobStore::remove( Hash const& hash )
+{
+    BlobRecord* blob = find( hash, BlobRecordType::BLOB );
+    if ( !blob || blob->references == 0 )
+        return false;
+
+    if ( --blob->references == 0 )
+        reference_chunks( *blob, -1 );
+    return true;
+}
+
+uint64_t kl::BlobStore::collect()
+{
+    if ( !*this )
+        return 0;
+
+    std::vector<BlobRecord> live;
+    uint64_t live_size = 0;
+    for ( uint64_t i = 0; i < header().slot_count; i++ )
+    {
+        BlobRecord const& record = records()[i];
+        if ( record.type == BlobRecordType::EMPTY || record.references == 0 )
+            continue;
+
+        live.push_back( record );
+        live_size += record.type == BlobRecordType::CHUNK ? record.byte_size : record.chunk_count * sizeof( Hash );
+    }
+
+    std::string const pack_path = m_directory + "/pack.bin";
+    std::string const packed_path = m_directory + "/pack.tmp";
+    std::error_code error;
+    std::filesystem::remove( packed_path, error );
+    MappedFile packed{ packed_path, true, live_size };
+    if ( !packed )
+        return 0;
+
+    uint64_t offset = 0;
+    for ( auto& record : live )
+    {
+        uint64_t const size = record.type == BlobRecordType::CHUNK ? record.byte_size : record.chunk_count * sizeof( Hash );
+        if ( size > 0 )
+            memcpy( packed.data() + offset, m_pack.data() + record.offset, size );
+        record.offset = offset;
+        offset += size;
+    }
+
+    uint64_t const old_size = header().pack_size;
+    bool const packed_flushed = packed.flush();
+    packed.close();
+
+    // Until index.new exists the live files are untouched, so a failure only has to reopen the old index.
+    std::string const index_path = m_directory + "/index.bin";
+    std::string const built_path = m_directory + "/index.tmp";
+    uint64_t const slot_count = std::bit_ceil( std::max<uint64_t>( live.size() * 2, INITIAL_SLOT_COUNT ) );
+    if ( !packed_flushed || !build_index( built_path, slot_count, live, live_size ) )
+    {
+        std::filesystem::remove( packed_path, error );
+        std::filesystem::remove( built_path, error );
+        m_index.open( index_path, true );
+        return 0;
+    }
+
+    m_pack.close();
+    std::filesystem::rename( built_path, m_directory + "/index.new", error );
+    if ( error )
+    {
+        std::filesystem::remove( packed_path, error );
+        std::filesystem::remove( built_path, error );
+        m_index.open( index_path, true );
+        m_pack.open( pack_path, true );
+        return 0;
+    }
+
+    if ( !verify( finish_swap( m_directory ), "Failed to replace \"", pack_path, "\"" ) || !m_index.open( index_path, true ) || !m_pack.open( pack_path, true ) )
+    {
+        close();
+        return 0;
+    }
+    return old_size - live_size;
+}
+
+kl::BlobStats kl::BlobStore::stats() const
+{
+    BlobStats result{};
+    if ( !*this )
+        return result;
+
+    for ( uint64_t i = 0; i < header().slot_count; i++ )
+    {
+        BlobRecord const& record = records()[i];
+        if ( record.references == 0 )
+            continue;
+
+        if ( record.type == BlobRecordType::BLOB )
+        {
+            result.blob_count += 1;
+            result.logical_bytes += record.byte_size;
+        }
+        else if ( record.type == BlobRecordType::CHUNK )
+        {
+            result.chunk_count += 1;
+            result.stored_bytes += record.byte_size;
+        }
+    }
+    return result;
+}
+
+std::vector<uint64_t> kl::BlobStore::split_chunks( void const* data, uint64_t byte_size )
+{
+    // Gear hashing, the top bits of the hash depend only on the last 64 bytes so cuts resynchronize after edits.
+    static constexpr uint64_t cut_mask = (AVERAGE_CHUNK_SIZE - 1) << (64 - std::countr_zero( AVERAGE_CHUNK_SIZE ));
+
+    uint8_t const* bytes = reinterpret_cast<uint8_t const*>(data);
+    std::vector<uint64_t> result;
+    for ( uint64_t start = 0; start < byte_size; )
+    {
+        uint64_t const end = std::min( byte_size, start + MAX_CHUNK_SIZE );
+        uint64_t cut = end;
+        uint64_t hash = 0;
+        for ( uint64_t i = start + MIN_CHUNK_SIZE; i < end; i++ )
+        {
+            hash = (hash << 1) + gear_table[bytes[i]];
+            if ( (hash & cut_mask) == 0 )
+            {
+                cut = i + 1;
+                break;
+            }
+        }
+        result.push_back( cut - start );
+        start = cut;
+    }
+    return result;
+}
+
+kl::BlobStore::Header& kl::BlobStore::header() const
+{
+    return *reinterpret_cast<Header*>(m_index.data());
+}
+
+kl::BlobRecord* kl::BlobStore::records() const
+{
+    return reinterpret_cast<BlobRecord*>(m_index.data() + sizeof( Header ));
+}
+
+kl::BlobRecord* kl::BlobStore::find( Hash const& hash, BlobRecordType type ) const
+{
+    uint64_t const mask = header().slot_count - 1;
+    for ( uint64_t slot = slot_of( hash, header().slot_count ); records()[slot].type != BlobRecordType::EMPTY; slot = (slot + 1) & mask )
+    {
+        BlobRecord& record = records()[slot];
+        if ( record.type == type && record.hash == hash )
+            return &record;
+    }
+    return nullptr;
+}
+
+bool kl::BlobStore::insert( BlobRecord const& record )
+{
+    if ( (header().used_count + 1) * 4 > header().slot_count * 3 )
+    {
+        std::vector<BlobRecord> existing;
+        existing.reserve( header().used_count + 1 );
+        for ( uint64_t i = 0; i < header().slot_count; i++ )
+        {
+            if ( records()[i].type != BlobRecordType::EMPTY )
+                existing.push_back( records()[i] );
+        }
+        existing.push_back( record );
+        return create_index( header().slot_count * 2, existing, header().pack_size );
+    }
+
+    uint64_t const mask = header().slot_count - 1;
+    uint64_t slot = slot_of( record.hash, header().slot_count );
+    while ( records()[slot].type != BlobRecordType::EMPTY )
+        slot = (slot + 1) & mask;
+
+    records()[slot] = record;
+    header().used_count += 1;
+    return true;
+}
+
+// The live index stays on disk until the new one is complete, a crash while growing leaves only index.tmp behind.
+bool kl::BlobStore::create_index( uint64_t slot_count, std::vector<BlobRecord> const& records, uint64_t pack_size )
+{
+    std::string const index_path = m_directory + "/index.bin";
+    std::string const built_path = m_directory + "/index.tmp";
+    std::error_code error;
+    if ( build_index( built_path, slot_count, records, pack_size ) )
+    {
+        std::filesystem::rename( built_path, index_path, error );
+        if ( !error )
+            return m_index.open( index_path, true );
+    }
+
+    std::filesystem::remove( built_path, error );
+    if ( std::filesystem::exists( index_path, error ) )
+        m_index.open( index_path, true );
+    return false;
+}
+
+bool kl::BlobStore::build_index( std::string const& path, uint64_t slot_count, std::vector<BlobRecord> const& records, uint64_t pack_size )
+{
+    m_index.close();
+    std::error_code error;
+    std::filesystem::remove( path, error );
+    if ( !m_index.open( path, true, sizeof( Header ) + slot_count * sizeof( BlobRecord ) ) )
+        return false;
+
+    memset( m_index.data(), 0, m_index.size() );
+    Header& index_header = header();
+    index_header.magic = INDEX_MAGIC;
+    index_header.version = INDEX_VERSION;
+    index_header.slot_count = slot_count;
+    index_header.pack_size = pack_size;
+    for ( auto& record : records )
+        insert( record );
+
+    bool const flushed = m_index.flush();
+    m_index.close();
+    return flushed;
+}
+
+bool kl::BlobStore::reserve( uint64_t byte_size )
+{
+    uint64_t const needed = header().pack_size + byte_size;
+    if ( needed <= m_pack.size() )
+        return true;
+
+    uint64_t const capacity = std::max( { needed, m_pack.size() + m_pack.size() / 2, MIN_PACK_SIZE } );
+    return m_pack.open( m_directory + "/pack.bin", true, capacity );
+}
+
+uint64_t kl::BlobStore::append( void const* data, uint64_t byte_size )
+{
+    uint64_t const offset = header().pack_size;
+    if ( byte_size > 0 )
+        memcpy( m_pack.data() + offset, data, byte_size );
+    header().pack_size += byte_size;
+    return offset;
+}
+
+void kl::BlobStore::reference_chunks( BlobRecord const& blob, int32_t delta )
+{
+    for ( uint32_t i = 0; i < blob.chunk_count; i++ )
+    {
+        Hash chunk_hash;
+        memcpy( chunk_hash.buffer, m_pack.data() + blob.offset + i * sizeof( Hash ), sizeof( Hash ) );
+        if ( BlobRecord* chunk = find( chunk_hash, BlobRecordType::CHUNK ) )
+            chunk->references += delta;
+    }
+}
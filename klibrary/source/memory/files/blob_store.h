@@ -0,0 +1,110 @@
+#pragma once
+
+#include "memory/files/mapped_file.h"
+#include "utility/hash/sha256.h"
+
+
+namespace kl
+{
+enum struct BlobRecordType : uint32_t
+{
+    EMPTY = 0,
+    CHUNK,
+    BLOB,
+};
+}
+
+namespace kl
+{
+// Chunks point at their bytes in the pack file, blobs point at a list of chunk hashes.
+struct BlobRecord
+{
+    Hash hash;
+    uint64_t offset = 0;
+    uint64_t byte_size = 0;
+    uint32_t chunk_count = 0;
+    uint32_t references = 0;
+    BlobRecordType type = BlobRecordType::EMPTY;
+    uint32_t padding = 0;
+};
+
+struct BlobView
+{
+    uint64_t byte_size = 0;
+    std::vector<std::span<byte const>> chunks;
+
+    std::string read() const;
+};
+
+struct BlobStats
+{
+    uint64_t blob_count = 0;
+    uint64_t chunk_count = 0;
+    uint64_t logical_bytes = 0;
+    uint64_t stored_bytes = 0;
+};
+}
+
+namespace kl
+{
+// Blobs are split with content-defined chunking, so similar files share most chunks. The index is
+// an open-addressing table mapped straight from disk. Views stay valid until the next put() or collect().
+// Rebuilt indices and packs are written next to the live files and swapped in, open() finishes a swap
+// that was interrupted.
+struct BlobStore : NoCopy
+{
+    static constexpr uint64_t MIN_CHUNK_SIZE = 16 * 1024;
+    static constexpr uint64_t AVERAGE_CHUNK_SIZE = 64 * 1024;
+    static constexpr uint64_t MAX_CHUNK_SIZE = 256 * 1024;
+
+    BlobStore();
+    BlobStore( std::string_view const& directory );
+    ~BlobStore();
+
+    operator bool() const;
+
+    bool open( std::string_view const& directory );
+    void close();
+    bool flush() const;
+
+    std::optional<Hash> put( void const* data, uint64_t byte_size );
+    std::optional<Hash> put( std::string_view const& data );
+
+    bool contains( Hash const& hash ) const;
+    std::optional<BlobView> get( Hash const& hash ) const;
+    std::optional<std::string> read( Hash const& hash ) const;
+
+    bool remove( Hash const& hash );
+    uint64_t collect();
+
+    BlobStats stats() const;
+
+    static std::vector<uint64_t> split_chunks( void const* data, uint64_t byte_size );
+
+private:
+    struct Header
+    {
+        uint32_t magic = 0;
+        uint32_t version = 0;
+        uint64_t slot_count = 0;
+        uint64_t used_count = 0;
+        uint64_t pack_size = 0;
+        uint8_t padding[32] = {};
+    };
+
+    std::string m_directory;
+    MappedFile m_index;
+    MappedFile m_pack;
+
+    Header& header() const;
+    BlobRecord* records() const;
+
+    BlobRecord* find( Hash const& hash, BlobRecordType type ) const;
+    bool insert( BlobRecord const& record );
+    bool create_index( uint64_t slot_count, std::vector<BlobRecord> const& records, uint64_t pack_size );
+    bool build_index( std::string const& path, uint64_t slot_count, std::vector<BlobRecord> const& records, uint64_t pack_size );
+    bool reserve( uint64_t byte_size );
+    uint64_t append( void const* data, uint64_t byte_size );
+    void reference_chunks( BlobRecord const& blob, int32_t delta );
+};
+}
@@ -40,9 +40,9 @@ bool kl::File::seek( int64_t position ) const
         return false;
 
     if ( position < 0 )
-        return !fseek( m_file, (long) position + 1, SEEK_END );
+        return !_fseeki64( m_file, position + 1, SEEK_END );
 
-    return !fseek( m_file, (long) position, SEEK_SET );
+    return !_fseeki64( m_file, position, SEEK_SET );
 }
 
 bool kl::File::move( int64_t delta ) const
@@ -51,7 +51,7 @@ bool kl::File::move( int64_t delta ) const
     {
         return false;
     }
-    return !fseek( m_file, (long) delta, SEEK_CUR );
+    return !_fseeki64( m_file, delta, SEEK_CUR );
 }
 
 bool kl::File::rewind() const
@@ -70,7 +70,7 @@ int64_t kl::File::tell() const
     {
         return -1;
     }
-    return ftell( m_file );
+    return _ftelli64( m_file );
 }
 
 std::string kl::file_extension( std::string_view const& filepath )
@@ -0,0 +1,95 @@
+#include "klibrary.h"
+
+
+kl::MappedFile::MappedFile()
+{}
+
+kl::MappedFile::MappedFile( std::string_view const& filepath, bool write, uint64_t byte_size )
+{
+    open( filepath, write, byte_size );
+}
+
+kl::MappedFile::~MappedFile()
+{
+    close();
+}
+
+kl::MappedFile::operator bool() const
+{
+    return m_file != INVALID_HANDLE_VALUE;
+}
+
+bool kl::MappedFile::open( std::string_view const& filepath, bool write, uint64_t byte_size )
+{
+    close();
+    m_file = CreateFileA( std::string( filepath ).data(), write ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, write ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+    if ( m_file == INVALID_HANDLE_VALUE )
+        return false;
+
+    LARGE_INTEGER size{};
+    if ( write && byte_size > 0 )
+    {
+        size.QuadPart = LONGLONG( byte_size );
+        if ( !SetFilePointerEx( m_file, size, nullptr, FILE_BEGIN ) || !SetEndOfFile( m_file ) )
+        {
+            close();
+            return false;
+        }
+    }
+    if ( !GetFileSizeEx( m_file, &size ) )
+    {
+        close();
+        return false;
+    }
+    m_size = uint64_t( size.QuadPart );
+    if ( m_size == 0 )
+        return true;
+
+    m_mapping = CreateFileMappingA( m_file, nullptr, write ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr );
+    if ( m_mapping )
+        m_data = (byte*) MapViewOfFile( m_mapping, write ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0 );
+    if ( !m_data )
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void kl::MappedFile::close()
+{
+    if ( m_data )
+    {
+        UnmapViewOfFile( m_data );
+        m_data = nullptr;
+    }
+    if ( m_mapping )
+    {
+        CloseHandle( m_mapping );
+        m_mapping = nullptr;
+    }
+    if ( m_file != INVALID_HANDLE_VALUE )
+    {
+        CloseHandle( m_file );
+        m_file = INVALID_HANDLE_VALUE;
+    }
+    m_size = 0;
+}
+
+bool kl::MappedFile::flush() const
+{
+    if ( !m_data )
+        return (bool) *this;
+    return FlushViewOfFile( m_data, 0 ) && FlushFileBuffers( m_file );
+}
+
+byte* kl::MappedFile::data() const
+{
+    return m_data;
+}
+
+uint64_t kl::MappedFile::size() const
+{
+    return m_size;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "apis/apis.h"
+
+
+namespace kl
+{
+// A byte_size larger than zero resizes the file when it is opened for writing.
+// Empty files open successfully but have no data.
+struct MappedFile : NoCopy
+{
+    MappedFile();
+    MappedFile( std::string_view const& filepath, bool write, uint64_t byte_size = 0 );
+    ~MappedFile();
+
+    operator bool() const;
+
+    bool open( std::string_view const& filepath, bool write, uint64_t byte_size = 0 );
+    void close();
+    bool flush() const;
+
+    byte* data() const;
+    uint64_t size() const;
+
+private:
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+    byte* m_data = nullptr;
+    uint64_t m_size = 0;
+};
+}
@@ -4,6 +4,8 @@
 #include "memory/safety/com_ref.h"
 #include "memory/files/file.h"
 #include "memory/files/dll.h"
+#include "memory/files/mapped_file.h"
+#include "memory/files/blob_store.h"
 
 
 namespace kl
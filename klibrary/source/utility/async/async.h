@@ -1,20 +1,33 @@
 #pragma once
 
-#include "apis/apis.h"
+#include "utility/async/thread_pool.h"
 
 
 namespace kl
 {
-inline int CPU_CORE_COUNT = (int) std::thread::hardware_concurrency();
+template<typename T, typename F>
+void async_for( T start_incl, T end_excl, F const& loop_body, Grain const& grain = {} )
+{
+    if ( end_excl <= start_incl )
+        return;
+
+    ThreadPool::global().run( uint64_t( end_excl - start_incl ), grain, [&]( uint64_t begin, uint64_t end )
+    {
+        for ( uint64_t i = begin; i < end; i++ )
+            loop_body( T( start_incl + T( i ) ) );
+    } );
 }
 
-namespace kl
-{
 template<typename T, typename F>
-void async_for( T start_incl, T end_excl, F const& loop_body )
+void async_for_range( T start_incl, T end_excl, F const& range_body, Grain const& grain = {} )
 {
-    std::ranges::iota_view view{ start_incl, end_excl };
-    std::for_each( std::execution::par, view.begin(), view.end(), loop_body );
+    if ( end_excl <= start_incl )
+        return;
+
+    ThreadPool::global().run( uint64_t( end_excl - start_incl ), grain, [&]( uint64_t begin, uint64_t end )
+    {
+        range_body( T( start_incl + T( begin ) ), T( start_incl + T( end ) ) );
+    } );
 }
 
 template<typename T, typename F>
@@ -0,0 +1,307 @@
+#include "klibrary.h"
+
+
+namespace kl
+{
+static constexpr size_t FRAME_CLASS_SIZE = 64;
+static constexpr size_t FRAME_CLASS_COUNT = 32;
+static constexpr size_t FRAME_CACHE_LIMIT = 256;
+
+struct FrameCache
+{
+    std::vector<void*> frames[FRAME_CLASS_COUNT];
+
+    ~FrameCache()
+    {
+        for ( auto& list : frames )
+        {
+            for ( void* frame : list )
+                ::operator delete( frame );
+        }
+    }
+};
+
+static size_t frame_class( size_t byte_size )
+{
+    return (byte_size + FRAME_CLASS_SIZE - 1) / FRAME_CLASS_SIZE - 1;
+}
+
+static void resume_frame( void* frame )
+{
+    std::coroutine_handle<>::from_address( frame ).resume();
+}
+
+// One thread sleeps until the closest deadline and hands expired coroutines to their pools.
+struct TimerService : NoCopy
+{
+    struct Timer
+    {
+        uint64_t deadline = 0;
+        std::coroutine_handle<> handle;
+        ThreadPool* pool = nullptr;
+
+        bool operator>( Timer const& other ) const
+        {
+            return deadline > other.deadline;
+        }
+    };
+
+    TimerService()
+    {
+        ThreadPool::global();
+        m_thread = std::thread( [this]
+        {
+            work();
+        } );
+    }
+
+    ~TimerService()
+    {
+        {
+            std::lock_guard lock{ m_mutex };
+            m_stop = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+    }
+
+    void add( float seconds, std::coroutine_handle<> handle, ThreadPool& pool )
+    {
+        {
+            std::lock_guard lock{ m_mutex };
+            m_timers.push( Timer{ time::now() + uint64_t( seconds * double( m_frequency ) ), handle, &pool } );
+        }
+        m_wake.notify_one();
+    }
+
+    static TimerService& global()
+    {
+        static TimerService service;
+        return service;
+    }
+
+private:
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> m_timers;
+    uint64_t const m_frequency = time::cpu_frequency();
+    bool m_stop = false;
+
+    void work()
+    {
+        std::unique_lock lock{ m_mutex };
+        while ( !m_stop )
+        {
+            if ( m_timers.empty() )
+            {
+                m_wake.wait( lock );
+                continue;
+            }
+
+            // Deadlines stay in counter ticks, float seconds lose precision once the process has run for a while.
+            uint64_t const current_time = time::now();
+            uint64_t const deadline = m_timers.top().deadline;
+            if ( deadline > current_time )
+            {
+                m_wake.wait_for( lock, std::chrono::duration<double>( double( deadline - current_time ) / double( m_frequency ) ) );
+                continue;
+            }
+
+            Timer const timer = m_timers.top();
+            m_timers.pop();
+            lock.unlock();
+            timer.pool->submit( resume_frame, timer.handle.address() );
+            lock.lock();
+        }
+    }
+};
+
+// WSAPoll has no way to be interrupted, so the wait list is polled with a short timeout and
+// newly added sockets are picked up on the next round.
+struct SocketPoller : NoCopy
+{
+    struct Waiter
+    {
+        uint64_t socket = 0;
+        short events = 0;
+        std::coroutine_handle<> handle;
+        ThreadPool* pool = nullptr;
+    };
+
+    SocketPoller()
+    {
+        ThreadPool::global();
+        m_thread = std::thread( [this]
+        {
+            work();
+        } );
+    }
+
+    ~SocketPoller()
+    {
+        {
+            std::lock_guard lock{ m_mutex };
+            m_stop = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+    }
+
+    void add( Waiter const& waiter )
+    {
+        {
+            std::lock_guard lock{ m_mutex };
+            m_waiters.push_back( waiter );
+        }
+        m_wake.notify_one();
+    }
+
+    static SocketPoller& global()
+    {
+        static SocketPoller poller;
+        return poller;
+    }
+
+private:
+    static constexpr int POLL_INTERVAL_MS = 10;
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::vector<Waiter> m_waiters;
+    bool m_stop = false;
+
+    void work()
+    {
+        std::vector<Waiter> waiters;
+        std::vector<WSAPOLLFD> descriptors;
+        while ( true )
+        {
+            {
+                std::unique_lock lock{ m_mutex };
+                m_wake.wait( lock, [&]
+                {
+                    return m_stop || !m_waiters.empty() || !waiters.empty();
+                } );
+                if ( m_stop )
+                    return;
+
+                waiters.insert( waiters.end(), m_waiters.begin(), m_waiters.end() );
+                m_waiters.clear();
+            }
+
+            descriptors.resize( waiters.size() );
+            for ( size_t i = 0; i < waiters.size(); i++ )
+            {
+                descriptors[i] = {};
+                descriptors[i].fd = (SOCKET) waiters[i].socket;
+                descriptors[i].events = waiters[i].events;
+            }
+
+            // On a poll error every waiter is resumed and finds out about the socket state on its own.
+            int const result = ::WSAPoll( descriptors.data(), (ULONG) descriptors.size(), POLL_INTERVAL_MS );
+            if ( result == 0 )
+                continue;
+
+            size_t kept_count = 0;
+            for ( size_t i = 0; i < waiters.size(); i++ )
+            {
+                if ( result < 0 || descriptors[i].revents != 0 )
+                {
+                    waiters[i].pool->submit( resume_frame, waiters[i].handle.address() );
+                }
+                else
+                {
+                    waiters[kept_count++] = waiters[i];
+                }
+            }
+            waiters.resize( kept_count );
+        }
+    }
+};
+}
+
+static thread_local kl::FrameCache _frame_cache;
+
+void* kl::FramePool::allocate( size_t byte_size )
+{
+    size_t const index = frame_class( byte_size );
+    if ( index >= FRAME_CLASS_COUNT )
+        return ::operator new( byte_size );
+
+    auto& list = _frame_cache.frames[index];
+    if ( list.empty() )
+        return ::operator new( (index + 1) * FRAME_CLASS_SIZE );
+
+    void* frame = list.back();
+    list.pop_back();
+    return frame;
+}
+
+void kl::FramePool::deallocate( void* frame, size_t byte_size )
+{
+    size_t const index = frame_class( byte_size );
+    if ( index >= FRAME_CLASS_COUNT )
+    {
+        ::operator delete( frame );
+        return;
+    }
+
+    // Frames can end on a different thread than they started on, they go to the cache of the freeing thread.
+    auto& list = _frame_cache.frames[index];
+    if ( list.size() >= FRAME_CACHE_LIMIT )
+    {
+        ::operator delete( frame );
+        return;
+    }
+    list.push_back( frame );
+}
+
+void kl::PoolAwaiter::await_suspend( std::coroutine_handle<> handle ) const
+{
+    pool->submit( resume_frame, handle.address() );
+}
+
+void kl::TimerAwaiter::await_suspend( std::coroutine_handle<> handle ) const
+{
+    TimerService::global().add( seconds, handle, *pool );
+}
+
+void kl::SocketAwaiter::await_suspend( std::coroutine_handle<> handle ) const
+{
+    SocketPoller::global().add( { socket, events, handle, pool } );
+}
+
+kl::PoolAwaiter kl::resume_on( ThreadPool& pool )
+{
+    return PoolAwaiter{ &pool };
+}
+
+kl::TimerAwaiter kl::resume_after( float seconds, ThreadPool& pool )
+{
+    return TimerAwaiter{ seconds, &pool };
+}
+
+kl::SocketAwaiter kl::resume_when_readable( Socket const& socket, ThreadPool& pool )
+{
+    return SocketAwaiter{ socket.id(), POLLRDNORM, &pool };
+}
+
+kl::SocketAwaiter kl::resume_when_writable( Socket const& socket, ThreadPool& pool )
+{
+    return SocketAwaiter{ socket.id(), POLLWRNORM, &pool };
+}
+
+kl::DetachedTask kl::spawn( Task<void> task )
+{
+    co_await task.when_ready();
+    try
+    {
+        task.result();
+    }
+    catch ( std::exception const& exception )
+    {
+        verify( false, "Spawned task failed: ", exception.what() );
+    }
+}
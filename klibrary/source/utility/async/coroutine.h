@@ -0,0 +1,510 @@
+#pragma once
+
+#include "utility/async/thread_pool.h"
+
+
+namespace kl
+{
+struct Socket;
+
+template<typename T = void>
+struct Task;
+}
+
+namespace kl
+{
+// Coroutine frames are recycled through per-thread free lists instead of going to the heap every time.
+struct FramePool
+{
+    static void* allocate( size_t byte_size );
+    static void deallocate( void* frame, size_t byte_size );
+};
+
+struct FramePromise
+{
+    static void* operator new( size_t byte_size )
+    {
+        return FramePool::allocate( byte_size );
+    }
+
+    static void operator delete( void* frame, size_t byte_size )
+    {
+        FramePool::deallocate( frame, byte_size );
+    }
+};
+}
+
+namespace kl
+{
+struct TaskPromiseBase : FramePromise
+{
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+
+    // Finishing transfers straight to the awaiting coroutine, so long chains don't grow the stack.
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        template<typename P>
+        std::coroutine_handle<> await_suspend( std::coroutine_handle<P> handle ) const noexcept
+        {
+            std::coroutine_handle<> const continuation = handle.promise().continuation;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept
+        {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept
+    {
+        return {};
+    }
+
+    FinalAwaiter final_suspend() const noexcept
+    {
+        return {};
+    }
+
+    void unhandled_exception()
+    {
+        error = std::current_exception();
+    }
+};
+
+template<typename T>
+struct TaskPromise : TaskPromiseBase
+{
+    std::optional<T> value;
+
+    Task<T> get_return_object();
+
+    template<typename V>
+    void return_value( V&& result )
+    {
+        value.emplace( std::forward<V>( result ) );
+    }
+
+    T result()
+    {
+        if ( error )
+            std::rethrow_exception( error );
+        return std::move( value.value() );
+    }
+};
+
+template<>
+struct TaskPromise<void> : TaskPromiseBase
+{
+    Task<void> get_return_object();
+
+    void return_void() const noexcept
+    {}
+
+    void result() const
+    {
+        if ( error )
+            std::rethrow_exception( error );
+    }
+};
+}
+
+namespace kl
+{
+// Lazy coroutine, the body starts when the task is awaited and resumes the awaiting coroutine when it finishes.
+template<typename T>
+struct Task : NoCopy
+{
+    using promise_type = TaskPromise<T>;
+
+    Task()
+    {}
+
+    explicit Task( std::coroutine_handle<promise_type> handle )
+        : m_handle( handle )
+    {}
+
+    Task( Task&& other ) noexcept
+        : m_handle( std::exchange( other.m_handle, {} ) )
+    {}
+
+    ~Task()
+    {
+        if ( m_handle )
+            m_handle.destroy();
+    }
+
+    Task& operator=( Task&& other ) noexcept
+    {
+        if ( this != &other )
+        {
+            if ( m_handle )
+                m_handle.destroy();
+            m_handle = std::exchange( other.m_handle, {} );
+        }
+        return *this;
+    }
+
+    operator bool() const
+    {
+        return bool( m_handle );
+    }
+
+    bool done() const
+    {
+        return m_handle && m_handle.done();
+    }
+
+    T result() const
+    {
+        return m_handle.promise().result();
+    }
+
+    auto operator co_await() const noexcept
+    {
+        struct Awaiter
+        {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept
+            {
+                return handle.done();
+            }
+
+            std::coroutine_handle<> await_suspend( std::coroutine_handle<> awaiting ) const noexcept
+            {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume() const
+            {
+                return handle.promise().result();
+            }
+        };
+        return Awaiter{ m_handle };
+    }
+
+    // Waits for the task to finish without taking its result or rethrowing its exception.
+    auto when_ready() const noexcept
+    {
+        struct Awaiter
+        {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept
+            {
+                return handle.done();
+            }
+
+            std::coroutine_handle<> await_suspend( std::coroutine_handle<> awaiting ) const noexcept
+            {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+            void await_resume() const noexcept
+            {}
+        };
+        return Awaiter{ m_handle };
+    }
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+template<typename T>
+Task<T> TaskPromise<T>::get_return_object()
+{
+    return Task<T>{ std::coroutine_handle<TaskPromise<T>>::from_promise( *this ) };
+}
+
+inline Task<void> TaskPromise<void>::get_return_object()
+{
+    return Task<void>{ std::coroutine_handle<TaskPromise<void>>::from_promise( *this ) };
+}
+}
+
+namespace kl
+{
+// Starts right away and frees its own frame at the end, used to drive tasks that nobody awaits.
+struct DetachedTask
+{
+    struct promise_type : FramePromise
+    {
+        DetachedTask get_return_object() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        void return_void() const noexcept
+        {}
+
+        void unhandled_exception() const noexcept
+        {
+            std::terminate();
+        }
+    };
+};
+}
+
+namespace kl
+{
+struct PoolAwaiter
+{
+    ThreadPool* pool = nullptr;
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend( std::coroutine_handle<> handle ) const;
+
+    void await_resume() const noexcept
+    {}
+};
+
+struct TimerAwaiter
+{
+    float seconds = 0.0f;
+    ThreadPool* pool = nullptr;
+
+    bool await_ready() const noexcept
+    {
+        return seconds <= 0.0f;
+    }
+
+    void await_suspend( std::coroutine_handle<> handle ) const;
+
+    void await_resume() const noexcept
+    {}
+};
+
+struct SocketAwaiter
+{
+    uint64_t socket = 0;
+    short events = 0;
+    ThreadPool* pool = nullptr;
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend( std::coroutine_handle<> handle ) const;
+
+    void await_resume() const noexcept
+    {}
+};
+
+PoolAwaiter resume_on( ThreadPool& pool = ThreadPool::global() );
+TimerAwaiter resume_after( float seconds, ThreadPool& pool = ThreadPool::global() );
+SocketAwaiter resume_when_readable( Socket const& socket, ThreadPool& pool = ThreadPool::global() );
+SocketAwaiter resume_when_writable( Socket const& socket, ThreadPool& pool = ThreadPool::global() );
+}
+
+namespace kl
+{
+struct WhenAllLatch
+{
+    std::atomic<size_t> count = 0;
+    std::coroutine_handle<> awaiting;
+
+    void arrive()
+    {
+        if ( count.fetch_sub( 1 ) == 1 )
+            awaiting.resume();
+    }
+};
+
+// The latch counts one extra arrival for the awaiting coroutine itself, so tasks that finish while
+// they are being started can't resume it before it has suspended.
+template<typename F>
+struct WhenAllAwaiter
+{
+    WhenAllLatch& latch;
+    size_t task_count = 0;
+    F start;
+
+    bool await_ready() const noexcept
+    {
+        return task_count == 0;
+    }
+
+    bool await_suspend( std::coroutine_handle<> awaiting )
+    {
+        latch.count = task_count + 1;
+        latch.awaiting = awaiting;
+        start();
+        return latch.count.fetch_sub( 1 ) != 1;
+    }
+
+    void await_resume() const noexcept
+    {}
+};
+
+template<typename T>
+DetachedTask when_all_entry( Task<T> const& task, WhenAllLatch& latch )
+{
+    co_await task.when_ready();
+    latch.arrive();
+}
+
+template<typename T>
+struct WhenAnyState
+{
+    std::vector<Task<T>> tasks;
+    std::atomic<int> gate = 2;
+    std::atomic<bool> decided = false;
+    size_t winner = 0;
+    std::coroutine_handle<> awaiting;
+};
+
+// Every entry owns a share of the state, tasks that lose the race keep running until they finish on their own.
+template<typename T>
+DetachedTask when_any_entry( std::shared_ptr<WhenAnyState<T>> state, size_t index )
+{
+    co_await state->tasks[index].when_ready();
+    if ( !state->decided.exchange( true ) )
+    {
+        state->winner = index;
+        if ( state->gate.fetch_sub( 1 ) == 1 )
+            state->awaiting.resume();
+    }
+}
+
+// Only refers to the state, the awaiting coroutine's frame keeps it alive for the whole await.
+template<typename T>
+struct WhenAnyAwaiter
+{
+    std::shared_ptr<WhenAnyState<T>> const& state;
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    bool await_suspend( std::coroutine_handle<> awaiting ) const
+    {
+        state->awaiting = awaiting;
+        for ( size_t i = 0; i < state->tasks.size(); i++ )
+            when_any_entry( state, i );
+        return state->gate.fetch_sub( 1 ) != 1;
+    }
+
+    void await_resume() const noexcept
+    {}
+};
+}
+
+namespace kl
+{
+template<typename... T>
+Task<std::tuple<T...>> when_all( Task<T>... tasks )
+{
+    WhenAllLatch latch;
+    auto start = [&]
+    {
+        (when_all_entry( tasks, latch ), ...);
+    };
+    co_await WhenAllAwaiter<decltype(start)>{ latch, sizeof...(T), start };
+    co_return std::tuple<T...>{ tasks.result()... };
+}
+
+template<typename T>
+Task<std::vector<T>> when_all( std::vector<Task<T>> tasks )
+{
+    WhenAllLatch latch;
+    auto start = [&]
+    {
+        for ( auto& task : tasks )
+            when_all_entry( task, latch );
+    };
+    co_await WhenAllAwaiter<decltype(start)>{ latch, tasks.size(), start };
+
+    std::vector<T> results;
+    results.reserve( tasks.size() );
+    for ( auto& task : tasks )
+        results.push_back( task.result() );
+    co_return results;
+}
+
+inline Task<void> when_all( std::vector<Task<void>> tasks )
+{
+    WhenAllLatch latch;
+    auto start = [&]
+    {
+        for ( auto& task : tasks )
+            when_all_entry( task, latch );
+    };
+    co_await WhenAllAwaiter<decltype(start)>{ latch, tasks.size(), start };
+
+    for ( auto& task : tasks )
+        task.result();
+}
+
+template<typename T>
+Task<std::pair<size_t, T>> when_any( std::vector<Task<T>> tasks )
+{
+    // Without tasks nothing would ever resume the awaiting coroutine, so the returned task fails right away.
+    if ( tasks.empty() )
+        throw std::invalid_argument( "when_any needs at least one task." );
+
+    auto state = std::make_shared<WhenAnyState<T>>();
+    state->tasks = std::move( tasks );
+    co_await WhenAnyAwaiter<T>{ state };
+    co_return std::pair<size_t, T>{ state->winner, state->tasks[state->winner].result() };
+}
+
+inline Task<size_t> when_any( std::vector<Task<void>> tasks )
+{
+    if ( tasks.empty() )
+        throw std::invalid_argument( "when_any needs at least one task." );
+
+    auto state = std::make_shared<WhenAnyState<void>>();
+    state->tasks = std::move( tasks );
+    co_await WhenAnyAwaiter<void>{ state };
+    state->tasks[state->winner].result();
+    co_return state->winner;
+}
+}
+
+namespace kl
+{
+DetachedTask spawn( Task<void> task );
+
+template<typename T>
+DetachedTask notify_when_ready( Task<T> const& task, std::atomic<bool>& ready )
+{
+    co_await task.when_ready();
+    ready = true;
+}
+
+// Blocks until the task finishes, the calling thread runs pool tasks in the meantime.
+template<typename T>
+T sync_wait( Task<T> task, ThreadPool& pool = ThreadPool::global() )
+{
+    std::atomic<bool> ready = false;
+    notify_when_ready( task, ready );
+    pool.wait( [&]
+    {
+        return ready.load();
+    } );
+    return task.result();
+}
+}
@@ -0,0 +1,184 @@
+#include "klibrary.h"
+
+
+kl::TaskGraph::TaskGraph( ThreadPool& pool )
+    : m_pool( pool )
+{}
+
+kl::TaskGraph::~TaskGraph()
+{
+    m_pool.wait( [&]
+    {
+        return done();
+    } );
+}
+
+kl::TaskGraph::ID kl::TaskGraph::add( std::function<void()> body )
+{
+    if ( m_size == m_blocks.size() * BLOCK_SIZE )
+        m_blocks.push_back( std::make_unique<Node[]>( BLOCK_SIZE ) );
+
+    Node& task = node( m_size );
+    task.graph = this;
+    task.body = std::move( body );
+    return m_size++;
+}
+
+kl::TaskGraph::ID kl::TaskGraph::add( std::function<void()> body, std::initializer_list<ID> dependencies )
+{
+    ID const task = add( std::move( body ) );
+    for ( ID dependency : dependencies )
+        depend( task, dependency );
+    return task;
+}
+
+kl::TaskGraph::ID kl::TaskGraph::then( ID task, std::function<void()> body )
+{
+    return add( std::move( body ), { task } );
+}
+
+void kl::TaskGraph::depend( ID task, ID dependency )
+{
+    if ( !verify( task < m_size && dependency < m_size, "Task graph dependency ", dependency, " -> ", task, " is out of range" ) )
+        return;
+
+    node( dependency ).successors.push_back( task );
+    node( task ).dependency_count += 1;
+}
+
+uint32_t kl::TaskGraph::size() const
+{
+    return m_size;
+}
+
+void kl::TaskGraph::clear()
+{
+    m_pool.wait( [&]
+    {
+        return done();
+    } );
+
+    // Blocks and successor lists keep their memory for the next build.
+    for ( ID id = 0; id < m_size; id++ )
+    {
+        Node& task = node( id );
+        task.body = nullptr;
+        task.successors.clear();
+        task.dependency_count = 0;
+    }
+    m_size = 0;
+    m_error = nullptr;
+}
+
+bool kl::TaskGraph::run()
+{
+    if ( !verify( done(), "Task graph is already running" ) || !verify( !has_cycle(), "Task graph has a dependency cycle" ) )
+        return false;
+
+    m_failed = false;
+    m_error = nullptr;
+    m_remaining = m_size;
+
+    std::vector<Node*> roots;
+    for ( ID id = 0; id < m_size; id++ )
+    {
+        Node& task = node( id );
+        task.pending = task.dependency_count;
+        if ( task.dependency_count == 0 )
+            roots.push_back( &task );
+    }
+    for ( Node* root : roots )
+        m_pool.submit( run_node, root );
+    return true;
+}
+
+void kl::TaskGraph::wait()
+{
+    m_pool.wait( [&]
+    {
+        return done();
+    } );
+
+    if ( m_error )
+        std::rethrow_exception( std::exchange( m_error, nullptr ) );
+}
+
+bool kl::TaskGraph::done() const
+{
+    return m_remaining.load() == 0;
+}
+
+kl::TaskGraph::Node& kl::TaskGraph::node( ID id ) const
+{
+    return m_blocks[id / BLOCK_SIZE][id % BLOCK_SIZE];
+}
+
+bool kl::TaskGraph::has_cycle() const
+{
+    std::vector<uint32_t> pending( m_size );
+    std::vector<ID> ready;
+    for ( ID id = 0; id < m_size; id++ )
+    {
+        pending[id] = node( id ).dependency_count;
+        if ( pending[id] == 0 )
+            ready.push_back( id );
+    }
+
+    uint32_t visited_count = 0;
+    while ( !ready.empty() )
+    {
+        ID const id = ready.back();
+        ready.pop_back();
+        visited_count += 1;
+        for ( ID successor : node( id ).successors )
+        {
+            if ( --pending[successor] == 0 )
+                ready.push_back( successor );
+        }
+    }
+    return visited_count != m_size;
+}
+
+void kl::TaskGraph::run_node( void* context )
+{
+    Node* task = static_cast<Node*>(context);
+    TaskGraph& graph = *task->graph;
+
+    // The first successor that becomes ready runs right here, the rest go back to the pool.
+    while ( task )
+    {
+        if ( !graph.m_failed )
+        {
+            try
+            {
+                task->body();
+            }
+            catch ( ... )
+            {
+                if ( !graph.m_failed.exchange( true ) )
+                    graph.m_error = std::current_exception();
+            }
+        }
+
+        Node* next = nullptr;
+        for ( ID id : task->successors )
+        {
+            Node& successor = graph.node( id );
+            if ( successor.pending.fetch_sub( 1 ) != 1 )
+                continue;
+
+            if ( next )
+            {
+                graph.m_pool.submit( run_node, &successor );
+            }
+            else
+            {
+                next = &successor;
+            }
+        }
+
+        // The graph can be destroyed once the last task is counted, so nothing touches it afterwards.
+        graph.m_remaining.fetch_sub( 1 );
+        task = next;
+    }
+}
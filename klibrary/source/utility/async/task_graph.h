@@ -0,0 +1,54 @@
+#pragma once
+
+#include "utility/async/thread_pool.h"
+
+
+namespace kl
+{
+// Tasks start once all of their dependencies finished, continuations are tasks that depend on one other task.
+// Nodes live in pooled blocks that clear() keeps for the next build. Tasks can't be added while the graph runs.
+struct TaskGraph : NoCopy
+{
+    using ID = uint32_t;
+
+    TaskGraph( ThreadPool& pool = ThreadPool::global() );
+    ~TaskGraph();
+
+    ID add( std::function<void()> body );
+    ID add( std::function<void()> body, std::initializer_list<ID> dependencies );
+    ID then( ID task, std::function<void()> body );
+    void depend( ID task, ID dependency );
+
+    uint32_t size() const;
+    void clear();
+
+    bool run();
+    void wait();
+    bool done() const;
+
+private:
+    static constexpr uint32_t BLOCK_SIZE = 256;
+
+    struct Node
+    {
+        TaskGraph* graph = nullptr;
+        std::function<void()> body;
+        std::vector<ID> successors;
+        uint32_t dependency_count = 0;
+        std::atomic<uint32_t> pending = 0;
+    };
+
+    ThreadPool& m_pool;
+    std::vector<std::unique_ptr<Node[]>> m_blocks;
+    uint32_t m_size = 0;
+
+    std::atomic<uint32_t> m_remaining = 0;
+    std::atomic<bool> m_failed = false;
+    std::exception_ptr m_error;
+
+    Node& node( ID id ) const;
+    bool has_cycle() const;
+
+    static void run_node( void* context );
+};
+}
@@ -0,0 +1,244 @@
+#include "klibrary.h"
+
+
+namespace kl
+{
+static constexpr uint64_t AUTO_TASKS_PER_THREAD = 8;
+static constexpr int SPIN_COUNT = 64;
+}
+
+static thread_local kl::ThreadPool const* _current_pool = nullptr;
+static thread_local size_t _current_queue = 0;
+
+kl::ThreadPool::ThreadPool( int thread_count )
+{
+    // The thread that starts a loop helps run it, so one worker less is needed.
+    int const worker_count = std::max( thread_count, 1 ) - 1;
+    m_queue_count = size_t( worker_count ) + 1;
+    m_queues = std::make_unique<Queue[]>( m_queue_count );
+    for ( int i = 0; i < worker_count; i++ )
+    {
+        m_workers.emplace_back( [this, i]
+        {
+            work( size_t( i ) );
+        } );
+    }
+}
+
+kl::ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock{ m_sleep_mutex };
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for ( auto& worker : m_workers )
+        worker.join();
+}
+
+int kl::ThreadPool::thread_count() const
+{
+    return int( m_queue_count );
+}
+
+kl::ThreadPool& kl::ThreadPool::global()
+{
+    static ThreadPool pool{ CPU_CORE_COUNT };
+    return pool;
+}
+
+void kl::ThreadPool::run( uint64_t count, Grain const& grain, RangeBody const& body )
+{
+    if ( count == 0 )
+        return;
+
+    uint64_t const thread_count = m_queue_count;
+    uint64_t grain_size = 0;
+    switch ( grain.mode )
+    {
+    case GrainMode::AUTO:
+        grain_size = count / (thread_count * AUTO_TASKS_PER_THREAD);
+        break;
+    case GrainMode::STATIC:
+        grain_size = (count + thread_count - 1) / thread_count;
+        break;
+    case GrainMode::EXPLICIT:
+        grain_size = grain.size;
+        break;
+    }
+    grain_size = std::max<uint64_t>( grain_size, 1 );
+
+    if ( thread_count == 1 || count <= grain_size )
+    {
+        body.invoke( body.context, 0, count );
+        return;
+    }
+
+    Job job;
+    job.body = body;
+    job.grain_size = grain_size;
+    job.remaining = count;
+
+    size_t const queue = current_queue();
+    if ( grain.mode == GrainMode::STATIC )
+    {
+        // Every queue gets its piece up front, stealing still evens out uneven pieces.
+        for ( uint64_t i = 0; i < thread_count; i++ )
+        {
+            uint64_t const begin = std::min( count, i * grain_size );
+            uint64_t const end = std::min( count, begin + grain_size );
+            if ( begin < end )
+                push( (queue + i) % m_queue_count, { &job, begin, end } );
+        }
+    }
+    else
+    {
+        push( queue, { &job, 0, count } );
+    }
+
+    // Finished jobs are signaled through the pool, the job itself can go away as soon as it reaches zero.
+    wait( [&]
+    {
+        return job.remaining.load() == 0;
+    } );
+
+    if ( job.error )
+        std::rethrow_exception( job.error );
+}
+
+void kl::ThreadPool::submit( void (*invoke)(void*), void* context )
+{
+    push( current_queue(), { nullptr, 0, 0, invoke, context } );
+}
+
+size_t kl::ThreadPool::current_queue() const
+{
+    // Worker threads use their own queue, every other thread shares the last one.
+    if ( _current_pool == this )
+        return _current_queue;
+    return m_queue_count - 1;
+}
+
+void kl::ThreadPool::push( size_t queue, Task const& task )
+{
+    {
+        std::lock_guard lock{ m_queues[queue].mutex };
+        m_queues[queue].tasks.push_back( task );
+    }
+    m_pending += 1;
+    if ( m_sleeping.load() > 0 )
+    {
+        std::lock_guard lock{ m_sleep_mutex };
+        m_wake.notify_one();
+    }
+    if ( m_waiting.load() > 0 )
+        signal();
+}
+
+bool kl::ThreadPool::pop( size_t queue, Task& task )
+{
+    for ( size_t i = 0; i < m_queue_count; i++ )
+    {
+        size_t const index = (queue + i) % m_queue_count;
+        std::lock_guard lock{ m_queues[index].mutex };
+        std::deque<Task>& tasks = m_queues[index].tasks;
+        if ( tasks.empty() )
+            continue;
+
+        if ( i == 0 )
+        {
+            task = tasks.back();
+            tasks.pop_back();
+        }
+        else
+        {
+            task = tasks.front();
+            tasks.pop_front();
+        }
+        m_pending -= 1;
+        return true;
+    }
+    return false;
+}
+
+bool kl::ThreadPool::try_run_one( size_t queue )
+{
+    Task task;
+    if ( !pop( queue, task ) )
+        return false;
+
+    execute( queue, task );
+    return true;
+}
+
+void kl::ThreadPool::execute( size_t queue, Task task )
+{
+    if ( task.invoke )
+    {
+        task.invoke( task.context );
+        signal();
+        return;
+    }
+
+    Job& job = *task.job;
+
+    // Splitting in halves keeps the larger part stealable while this thread works through the rest.
+    while ( task.end - task.begin > job.grain_size )
+    {
+        uint64_t const middle = task.begin + (task.end - task.begin) / 2;
+        push( queue, { &job, middle, task.end } );
+        task.end = middle;
+    }
+
+    if ( !job.failed )
+    {
+        try
+        {
+            job.body.invoke( job.body.context, task.begin, task.end );
+        }
+        catch ( ... )
+        {
+            if ( !job.failed.exchange( true ) )
+                job.error = std::current_exception();
+        }
+    }
+
+    if ( job.remaining.fetch_sub( task.end - task.begin ) == task.end - task.begin )
+        signal();
+}
+
+void kl::ThreadPool::signal()
+{
+    m_signal += 1;
+    if ( m_waiting.load() > 0 )
+        m_signal.notify_all();
+}
+
+void kl::ThreadPool::work( size_t queue )
+{
+    _current_pool = this;
+    _current_queue = queue;
+
+    while ( true )
+    {
+        bool found = false;
+        for ( int i = 0; i < SPIN_COUNT && !found; i++ )
+        {
+            found = try_run_one( queue );
+            if ( !found )
+                std::this_thread::yield();
+        }
+        if ( found )
+            continue;
+
+        std::unique_lock lock{ m_sleep_mutex };
+        m_sleeping += 1;
+        m_wake.wait( lock, [&]
+        {
+            return m_pending.load() > 0 || m_stop.load();
+        } );
+        m_sleeping -= 1;
+        if ( m_stop )
+            return;
+    }
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "apis/apis.h"
+
+
+namespace kl
+{
+inline int CPU_CORE_COUNT = (int) std::thread::hardware_concurrency();
+}
+
+namespace kl
+{
+enum struct GrainMode : uint8_t
+{
+    AUTO = 0,
+    STATIC,
+    EXPLICIT,
+};
+
+// AUTO splits ranges on demand down to a size picked from the thread count, STATIC cuts one
+// piece per thread up front and EXPLICIT splits down to the given size.
+struct Grain
+{
+    GrainMode mode = GrainMode::AUTO;
+    uint64_t size = 0;
+};
+}
+
+namespace kl
+{
+// Persistent workers with one deque each. Owners pop from the back, idle threads steal from the front,
+// and a thread waiting on a loop keeps running tasks instead of blocking.
+struct ThreadPool : NoCopy
+{
+    ThreadPool( int thread_count = CPU_CORE_COUNT );
+    ~ThreadPool();
+
+    int thread_count() const;
+
+    template<typename F>
+    void run( uint64_t count, Grain const& grain, F const& range_body )
+    {
+        RangeBody const body{ &range_body, []( void const* context, uint64_t begin, uint64_t end )
+        {
+            (*static_cast<F const*>(context))(begin, end);
+        } };
+        run( count, grain, body );
+    }
+
+    void submit( void (*invoke)(void*), void* context );
+
+    // Runs queued tasks until done() returns true, finished and newly queued tasks wake the waiting thread.
+    template<typename F>
+    void wait( F const& done )
+    {
+        size_t const queue = current_queue();
+        while ( !done() )
+        {
+            uint64_t const signal = m_signal.load();
+            if ( try_run_one( queue ) )
+                continue;
+
+            m_waiting += 1;
+            if ( m_pending.load() == 0 && !done() )
+                m_signal.wait( signal );
+            m_waiting -= 1;
+        }
+    }
+
+    static ThreadPool& global();
+
+private:
+    struct RangeBody
+    {
+        void const* context = nullptr;
+        void (*invoke)(void const*, uint64_t, uint64_t) = nullptr;
+    };
+
+    struct Job
+    {
+        RangeBody body;
+        uint64_t grain_size = 0;
+        std::atomic<uint64_t> remaining = 0;
+        std::atomic<bool> failed = false;
+        std::exception_ptr error;
+    };
+
+    struct Task
+    {
+        Job* job = nullptr;
+        uint64_t begin = 0;
+        uint64_t end = 0;
+        void (*invoke)(void*) = nullptr;
+        void* context = nullptr;
+    };
+
+    struct alignas(64) Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::thread> m_workers;
+    std::unique_ptr<Queue[]> m_queues;
+    size_t m_queue_count = 0;
+
+    std::atomic<uint64_t> m_pending = 0;
+    std::atomic<uint64_t> m_signal = 0;
+    std::atomic<int> m_waiting = 0;
+    std::atomic<int> m_sleeping = 0;
+    std::atomic<bool> m_stop = false;
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_wake;
+
+    void run( uint64_t count, Grain const& grain, RangeBody const& body );
+
+    size_t current_queue() const;
+    void push( size_t queue, Task const& task );
+    bool pop( size_t queue, Task& task );
+    bool try_run_one( size_t queue );
+    void execute( size_t queue, Task task );
+    void signal();
+    void work( size_t queue );
+};
+}
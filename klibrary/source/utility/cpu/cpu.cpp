@@ -0,0 +1,50 @@
+#include "klibrary.h"
+
+
+struct CPUFeatures
+{
+    bool sse42 = false;
+    bool avx2 = false;
+    bool sha = false;
+};
+
+static CPUFeatures const& cpu_features()
+{
+    static CPUFeatures const features = []
+    {
+        CPUFeatures result{};
+        int info[4] = {};
+        __cpuid( info, 0 );
+        int const max_leaf = info[0];
+
+        __cpuid( info, 1 );
+        result.sse42 = info[2] & (1 << 20);
+        bool const os_xsave = info[2] & (1 << 27);
+        bool const avx = info[2] & (1 << 28);
+        bool const ymm_state = os_xsave && (_xgetbv( 0 ) & 0x6) == 0x6;
+
+        if ( max_leaf >= 7 )
+        {
+            __cpuidex( info, 7, 0 );
+            result.avx2 = avx && ymm_state && (info[1] & (1 << 5));
+            result.sha = result.sse42 && (info[1] & (1 << 29));
+        }
+        return result;
+    }();
+    return features;
+}
+
+bool kl::cpu::has_sse42()
+{
+    return cpu_features().sse42;
+}
+
+bool kl::cpu::has_avx2()
+{
+    return cpu_features().avx2;
+}
+
+bool kl::cpu::has_sha()
+{
+    return cpu_features().sha;
+}
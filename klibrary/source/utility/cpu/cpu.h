@@ -0,0 +1,11 @@
+#pragma once
+
+#include "apis/apis.h"
+
+
+namespace kl::cpu
+{
+bool has_sse42();
+bool has_avx2();
+bool has_sha();
+}
@@ -3,48 +3,270 @@
 
 namespace kl
 {
-static constexpr int MIN_KEY_SIZE = 1;
-static constexpr int MAX_KEY_SIZE = 16;
+static constexpr uint64_t PARALLEL_CHUNK_SIZE = 256 * 1024;
+static constexpr uint64_t STREAM_BUFFER_SIZE = 4 * 1024 * 1024;
 }
 
-kl::Encryptor::Encryptor( int key_count )
+#define ROTLEFT(a, b) (((a) << (b)) | ((a) >> (32 - (b))))
+
+#define QUARTER_ROUND(a, b, c, d) \
+    a += b; d ^= a; d = ROTLEFT(d, 16); \
+    c += d; b ^= c; b = ROTLEFT(b, 12); \
+    a += b; d ^= a; d = ROTLEFT(d, 8); \
+    c += d; b ^= c; b = ROTLEFT(b, 7);
+
+static void load_state( kl::Encryptor const& encryptor, uint32_t* state )
+{
+    static constexpr uint32_t constants[4] = { 0x61707865, 0x3320646e, 0x79622d32, 0x6b206574 };
+    memcpy( state, constants, sizeof( constants ) );
+    memcpy( state + 4, encryptor.key.data(), encryptor.key.size() );
+    state[12] = 0;
+    memcpy( state + 13, encryptor.nonce.data(), encryptor.nonce.size() );
+}
+
+static void keystream_block( uint32_t const* input, uint32_t counter, uint8_t* output )
 {
-    keys.resize( key_count );
-    for ( auto& key : keys )
+    uint32_t state[16] = {};
+    memcpy( state, input, sizeof( state ) );
+    state[12] = counter;
+
+    uint32_t x[16] = {};
+    memcpy( x, state, sizeof( x ) );
+    for ( int i = 0; i < 10; i++ )
     {
-        key.resize( random::gen_int( MIN_KEY_SIZE, MAX_KEY_SIZE + 1 ) );
-        for ( auto& value : key )
-            value = random::gen_byte();
+        QUARTER_ROUND( x[0], x[4], x[8], x[12] );
+        QUARTER_ROUND( x[1], x[5], x[9], x[13] );
+        QUARTER_ROUND( x[2], x[6], x[10], x[14] );
+        QUARTER_ROUND( x[3], x[7], x[11], x[15] );
+        QUARTER_ROUND( x[0], x[5], x[10], x[15] );
+        QUARTER_ROUND( x[1], x[6], x[11], x[12] );
+        QUARTER_ROUND( x[2], x[7], x[8], x[13] );
+        QUARTER_ROUND( x[3], x[4], x[9], x[14] );
     }
+    for ( int i = 0; i < 16; i++ )
+        x[i] += state[i];
+    memcpy( output, x, sizeof( x ) );
 }
 
-void kl::Encryptor::run_pass( void* data, uint64_t byte_size ) const
+static void xor_block( uint32_t const* input, uint32_t counter, uint8_t* data, uint64_t skip, uint64_t byte_size )
 {
-    for ( auto& key : keys )
+    uint8_t keystream[kl::Encryptor::BLOCK_SIZE] = {};
+    keystream_block( input, counter, keystream );
+    for ( uint64_t i = 0; i < byte_size; i++ )
+        data[i] ^= keystream[skip + i];
+}
+
+#define QUARTER_ROUND_AVX2(a, b, c, d) \
+    a = _mm256_add_epi32( a, b ); d = _mm256_shuffle_epi8( _mm256_xor_si256( d, a ), rotate16 ); \
+    c = _mm256_add_epi32( c, d ); b = _mm256_xor_si256( b, c ); b = _mm256_or_si256( _mm256_slli_epi32( b, 12 ), _mm256_srli_epi32( b, 20 ) ); \
+    a = _mm256_add_epi32( a, b ); d = _mm256_shuffle_epi8( _mm256_xor_si256( d, a ), rotate8 ); \
+    c = _mm256_add_epi32( c, d ); b = _mm256_xor_si256( b, c ); b = _mm256_or_si256( _mm256_slli_epi32( b, 7 ), _mm256_srli_epi32( b, 25 ) );
+
+// Turns 8 words of 8 blocks (one block per lane) into 8 rows of 8 consecutive words, row i is block i.
+static void transpose_avx2( __m256i* words )
+{
+    __m256i low[4] = {};
+    __m256i high[4] = {};
+    for ( int i = 0; i < 4; i++ )
     {
-        for ( uint64_t i = 0; i < byte_size; i++ )
-            reinterpret_cast<byte*>(data)[i] ^= key[i % key.size()];
+        low[i] = _mm256_unpacklo_epi32( words[i * 2], words[i * 2 + 1] );
+        high[i] = _mm256_unpackhi_epi32( words[i * 2], words[i * 2 + 1] );
+    }
+
+    __m256i const rows[8] = {
+        _mm256_unpacklo_epi64( low[0], low[1] ),
+        _mm256_unpackhi_epi64( low[0], low[1] ),
+        _mm256_unpacklo_epi64( high[0], high[1] ),
+        _mm256_unpackhi_epi64( high[0], high[1] ),
+        _mm256_unpacklo_epi64( low[2], low[3] ),
+        _mm256_unpackhi_epi64( low[2], low[3] ),
+        _mm256_unpacklo_epi64( high[2], high[3] ),
+        _mm256_unpackhi_epi64( high[2], high[3] ),
+    };
+    for ( int i = 0; i < 4; i++ )
+    {
+        words[i] = _mm256_permute2x128_si256( rows[i], rows[i + 4], 0x20 );
+        words[i + 4] = _mm256_permute2x128_si256( rows[i], rows[i + 4], 0x31 );
     }
 }
 
-bool kl::Encryptor::key_size_exists( uint64_t size ) const
+// Processes 8 consecutive blocks at once, every lane of a register is a different block counter.
+static void xor_blocks_avx2( uint32_t const* input, uint32_t counter, uint8_t* data, uint64_t group_count )
 {
-    for ( auto& key : keys )
+    __m256i const rotate16 = _mm256_setr_epi8( 2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13, 2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13 );
+    __m256i const rotate8 = _mm256_setr_epi8( 3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14, 3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14 );
+    __m256i const lane_counters = _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 );
+
+    __m256i state[16] = {};
+    for ( int i = 0; i < 16; i++ )
+        state[i] = _mm256_set1_epi32( int( input[i] ) );
+
+    for ( uint64_t group = 0; group < group_count; group++, counter += 8, data += kl::Encryptor::BLOCK_SIZE * 8 )
     {
-        if ( key.size() == size )
-            return true;
+        state[12] = _mm256_add_epi32( _mm256_set1_epi32( int( counter ) ), lane_counters );
+
+        __m256i x[16] = {};
+        for ( int i = 0; i < 16; i++ )
+            x[i] = state[i];
+        for ( int i = 0; i < 10; i++ )
+        {
+            QUARTER_ROUND_AVX2( x[0], x[4], x[8], x[12] );
+            QUARTER_ROUND_AVX2( x[1], x[5], x[9], x[13] );
+            QUARTER_ROUND_AVX2( x[2], x[6], x[10], x[14] );
+            QUARTER_ROUND_AVX2( x[3], x[7], x[11], x[15] );
+            QUARTER_ROUND_AVX2( x[0], x[5], x[10], x[15] );
+            QUARTER_ROUND_AVX2( x[1], x[6], x[11], x[12] );
+            QUARTER_ROUND_AVX2( x[2], x[7], x[8], x[13] );
+            QUARTER_ROUND_AVX2( x[3], x[4], x[9], x[14] );
+        }
+        for ( int i = 0; i < 16; i++ )
+            x[i] = _mm256_add_epi32( x[i], state[i] );
+
+        transpose_avx2( x );
+        transpose_avx2( x + 8 );
+        for ( int block = 0; block < 8; block++ )
+        {
+            for ( int half = 0; half < 2; half++ )
+            {
+                __m256i* address = (__m256i*) (data + block * kl::Encryptor::BLOCK_SIZE + half * 32);
+                _mm256_storeu_si256( address, _mm256_xor_si256( _mm256_loadu_si256( address ), x[half * 8 + block] ) );
+            }
+        }
     }
-    return false;
 }
 
-std::ostream& kl::operator<<( std::ostream& stream, Encryptor const& encryptor )
+static void xor_keystream( uint32_t const* input, uint8_t* data, uint64_t byte_size, uint64_t offset )
 {
-    for ( uint64_t i = 0; i < encryptor.keys.size(); i++ )
+    static bool const avx2 = kl::cpu::has_avx2();
+
+    uint32_t counter = uint32_t( offset / kl::Encryptor::BLOCK_SIZE );
+    uint64_t const skip = offset % kl::Encryptor::BLOCK_SIZE;
+    if ( skip > 0 )
+    {
+        uint64_t const size = std::min( byte_size, kl::Encryptor::BLOCK_SIZE - skip );
+        xor_block( input, counter++, data, skip, size );
+        data += size;
+        byte_size -= size;
+    }
+
+    if ( avx2 )
     {
-        stream << "keys[" << i << "] = { ";
-        for ( uint64_t k = 0; k < (encryptor.keys[i].size() - 1); k++ )
-            stream << int( encryptor.keys[i][k] ) << ", ";
-        stream << int( encryptor.keys[i].back() ) << " }" << '\n';
+        uint64_t const group_count = byte_size / (kl::Encryptor::BLOCK_SIZE * 8);
+        xor_blocks_avx2( input, counter, data, group_count );
+        counter += uint32_t( group_count * 8 );
+        data += group_count * kl::Encryptor::BLOCK_SIZE * 8;
+        byte_size -= group_count * kl::Encryptor::BLOCK_SIZE * 8;
     }
-    return stream;
+
+    for ( ; byte_size > 0; counter++ )
+    {
+        uint64_t const size = std::min( byte_size, kl::Encryptor::BLOCK_SIZE );
+        xor_block( input, counter, data, 0, size );
+        data += size;
+        byte_size -= size;
+    }
+}
+
+kl::Encryptor::Encryptor()
+{
+    std::random_device device;
+    for ( auto& value : key )
+        value = byte( device() );
+    for ( auto& value : nonce )
+        value = byte( device() );
+}
+
+kl::Encryptor::Encryptor( std::array<byte, KEY_SIZE> const& key, std::array<byte, NONCE_SIZE> const& nonce )
+    : key( key ), nonce( nonce )
+{}
+
+bool kl::Encryptor::run_pass( void* data, uint64_t byte_size, uint64_t offset ) const
+{
+    if ( !verify( offset <= MAX_STREAM_SIZE && byte_size <= MAX_STREAM_SIZE - offset, "Encryptor stream can't be longer than ", MAX_STREAM_SIZE, " bytes" ) )
+        return false;
+
+    uint32_t input[16] = {};
+    load_state( *this, input );
+
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(data);
+    if ( byte_size <= PARALLEL_CHUNK_SIZE )
+    {
+        xor_keystream( input, bytes, byte_size, offset );
+        return true;
+    }
+
+    // Chunk boundaries are block aligned in the stream, every chunk derives its own counter from its offset.
+    uint64_t const first_size = PARALLEL_CHUNK_SIZE - offset % PARALLEL_CHUNK_SIZE;
+    uint64_t const chunk_count = 1 + (byte_size - first_size + PARALLEL_CHUNK_SIZE - 1) / PARALLEL_CHUNK_SIZE;
+    async_for( uint64_t( 0 ), chunk_count, [&]( uint64_t chunk )
+    {
+        uint64_t const start = chunk == 0 ? 0 : first_size + (chunk - 1) * PARALLEL_CHUNK_SIZE;
+        uint64_t const end = std::min( byte_size, first_size + chunk * PARALLEL_CHUNK_SIZE );
+        xor_keystream( input, bytes + start, end - start, offset + start );
+    } );
+    return true;
+}
+
+uint64_t kl::Encryptor::run_pass( File const& input, File& output, uint64_t offset ) const
+{
+    // The next buffer is read while the current one is encrypted and written.
+    std::vector<byte> buffers[2] = { std::vector<byte>( STREAM_BUFFER_SIZE ), std::vector<byte>( STREAM_BUFFER_SIZE ) };
+    uint64_t read_size = input.read( buffers[0].data(), buffers[0].size() );
+    uint64_t total_size = 0;
+    for ( int current = 0; read_size > 0; current ^= 1 )
+    {
+        std::future<uint64_t> next_read = std::async( std::launch::async, [&]
+        {
+            return input.read( buffers[current ^ 1].data(), buffers[current ^ 1].size() );
+        } );
+
+        // Data that couldn't be encrypted is never written, the output stops short instead.
+        if ( !run_pass( buffers[current].data(), read_size, offset + total_size ) )
+        {
+            next_read.wait();
+            break;
+        }
+        uint64_t const written_size = output.write( buffers[current].data(), read_size );
+        total_size += written_size;
+
+        uint64_t const next_size = next_read.get();
+        if ( written_size != read_size )
+            break;
+        read_size = next_size;
+    }
+    return total_size;
+}
+
+int kl::Encryptor::send( Socket const& socket, void const* data, int byte_size, uint64_t& offset ) const
+{
+    std::vector<byte> buffer( reinterpret_cast<byte const*>(data), reinterpret_cast<byte const*>(data) + byte_size );
+    if ( !run_pass( buffer.data(), buffer.size(), offset ) )
+        return -1;
+    int const result = socket.send( buffer.data(), byte_size );
+    if ( result > 0 )
+        offset += result;
+    return result;
+}
+
+int kl::Encryptor::receive( Socket const& socket, void* data, int byte_size, uint64_t& offset ) const
+{
+    int const result = socket.receive( data, byte_size );
+    if ( result > 0 )
+    {
+        if ( !run_pass( data, result, offset ) )
+            return -1;
+        offset += result;
+    }
+    return result;
+}
+
+std::ostream& kl::operator<<( std::ostream& stream, Encryptor const& encryptor )
+{
+    stream << "key = ";
+    for ( byte value : encryptor.key )
+        stream << std::hex << std::setw( 2 ) << std::setfill( '0' ) << int( value );
+    stream << '\n' << "nonce = ";
+    for ( byte value : encryptor.nonce )
+        stream << std::hex << std::setw( 2 ) << std::setfill( '0' ) << int( value );
+    return stream << std::dec << std::setfill( ' ' ) << '\n';
 }
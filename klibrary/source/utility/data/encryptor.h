@@ -5,22 +5,36 @@
 
 namespace kl
 {
+struct File;
+struct Socket;
+}
+
+namespace kl
+{
+// ChaCha20 stream cipher, encrypting and decrypting are the same pass. The keystream is addressed
+// by byte offset, so any range of a stream can be processed on its own. One nonce covers 256 GB.
+// A key and nonce pair must only ever encrypt one message, passing different data over the same
+// offsets reuses the keystream and leaks the xor of both plaintexts.
 struct Encryptor
 {
-    std::vector<std::vector<byte>> keys;
+    static constexpr uint64_t KEY_SIZE = 32;
+    static constexpr uint64_t NONCE_SIZE = 12;
+    static constexpr uint64_t BLOCK_SIZE = 64;
+    static constexpr uint64_t MAX_STREAM_SIZE = BLOCK_SIZE << 32;
+
+    std::array<byte, KEY_SIZE> key = {};
+    std::array<byte, NONCE_SIZE> nonce = {};
 
-    Encryptor( int key_count = 5 );
+    Encryptor();
+    Encryptor( std::array<byte, KEY_SIZE> const& key, std::array<byte, NONCE_SIZE> const& nonce );
 
-    void run_pass( void* data, uint64_t byte_size ) const;
+    // Returns false and leaves the data untouched if the range goes past the end of the stream.
+    bool run_pass( void* data, uint64_t byte_size, uint64_t offset ) const;
 
-    template<typename T>
-    void run_pass( T& object ) const
-    {
-        run_pass( &object, sizeof( T ) );
-    }
+    uint64_t run_pass( File const& input, File& output, uint64_t offset ) const;
 
-private:
-    bool key_size_exists( uint64_t size ) const;
+    int send( Socket const& socket, void const* data, int byte_size, uint64_t& offset ) const;
+    int receive( Socket const& socket, void* data, int byte_size, uint64_t& offset ) const;
 };
 }
 
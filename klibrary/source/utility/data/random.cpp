@@ -1,21 +1,345 @@
 #include "klibrary.h"
 
 
-static thread_local std::mt19937 _random_init = []
+namespace kl
+{
+static constexpr uint64_t BULK_MIN_SIZE = 64;
+}
+
+static uint64_t split_mix( uint64_t& state )
+{
+    uint64_t result = (state += 0x9E3779B97F4A7C15);
+    result = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9;
+    result = (result ^ (result >> 27)) * 0x94D049BB133111EB;
+    return result ^ (result >> 31);
+}
+
+static thread_local kl::random::Engine _random_init = []
 {
     std::random_device device{};
-    std::srand( device() );
-    return std::mt19937{ device() };
+    return kl::random::Engine{ (uint64_t( device() ) << 32) | device() };
 }();
 
+// Four interleaved generators seeded from the thread engine. The scalar and AVX2 paths produce the same
+// sequence, every step yields one 64 bit value per lane in lane order.
+struct BulkEngine
+{
+    kl::Xoshiro256 lanes[4];
+
+    BulkEngine( kl::random::Engine& engine )
+        : lanes{ kl::Xoshiro256{ engine() }, kl::Xoshiro256{ engine() }, kl::Xoshiro256{ engine() }, kl::Xoshiro256{ engine() } }
+    {}
+
+    template<typename F>
+    void run_scalar( uint64_t step_count, F const& consume )
+    {
+        for ( uint64_t step = 0; step < step_count; step++ )
+        {
+            uint64_t const values[4] = { lanes[0](), lanes[1](), lanes[2](), lanes[3]() };
+            consume( step, values );
+        }
+    }
+
+    template<typename F>
+    void run_avx2( uint64_t step_count, F const& consume )
+    {
+        __m256i state[4] = {};
+        for ( int i = 0; i < 4; i++ )
+            state[i] = _mm256_setr_epi64x( lanes[0].state[i], lanes[1].state[i], lanes[2].state[i], lanes[3].state[i] );
+
+        for ( uint64_t step = 0; step < step_count; step++ )
+        {
+            __m256i const sum = _mm256_add_epi64( state[0], state[3] );
+            consume( step, _mm256_add_epi64( _mm256_or_si256( _mm256_slli_epi64( sum, 23 ), _mm256_srli_epi64( sum, 41 ) ), state[0] ) );
+
+            __m256i const shifted = _mm256_slli_epi64( state[1], 17 );
+            state[2] = _mm256_xor_si256( state[2], state[0] );
+            state[3] = _mm256_xor_si256( state[3], state[1] );
+            state[1] = _mm256_xor_si256( state[1], state[2] );
+            state[0] = _mm256_xor_si256( state[0], state[3] );
+            state[2] = _mm256_xor_si256( state[2], shifted );
+            state[3] = _mm256_or_si256( _mm256_slli_epi64( state[3], 45 ), _mm256_srli_epi64( state[3], 19 ) );
+        }
+
+        alignas(32) uint64_t values[4][4] = {};
+        for ( int i = 0; i < 4; i++ )
+            _mm256_store_si256( (__m256i*) values[i], state[i] );
+        for ( int lane = 0; lane < 4; lane++ )
+        {
+            for ( int i = 0; i < 4; i++ )
+                lanes[lane].state[i] = values[i][lane];
+        }
+    }
+};
+
+// Fills whole groups of 8 floats with the bulk engine, the tail comes from the thread engine.
+static void fill_float_values( float* data, uint64_t count, float start_inclusive, float end_inclusive )
+{
+    static bool const avx2 = kl::cpu::has_avx2();
+
+    float const range = end_inclusive - start_inclusive;
+    uint64_t const step_count = count >= kl::BULK_MIN_SIZE ? count / 8 : 0;
+    if ( step_count > 0 && avx2 )
+    {
+        __m256 const scale = _mm256_set1_ps( range / 16777215.0f );
+        __m256 const offset = _mm256_set1_ps( start_inclusive );
+        BulkEngine bulk{ _random_init };
+        bulk.run_avx2( step_count, [&]( uint64_t step, __m256i values )
+        {
+            __m256 const floats = _mm256_cvtepi32_ps( _mm256_srli_epi32( values, 8 ) );
+            _mm256_storeu_ps( data + step * 8, _mm256_add_ps( _mm256_mul_ps( floats, scale ), offset ) );
+        } );
+    }
+    else if ( step_count > 0 )
+    {
+        float const scale = range / 16777215.0f;
+        BulkEngine bulk{ _random_init };
+        bulk.run_scalar( step_count, [&]( uint64_t step, uint64_t const* values )
+        {
+            for ( int i = 0; i < 8; i++ )
+                data[step * 8 + i] = float( uint32_t( values[i / 2] >> (i % 2 * 32) ) >> 8 ) * scale + start_inclusive;
+        } );
+    }
+
+    for ( uint64_t i = step_count * 8; i < count; i += 2 )
+    {
+        uint64_t const value = _random_init();
+        data[i] = kl::random::to_float( uint32_t( value >> 32 ) ) * range + start_inclusive;
+        if ( i + 1 < count )
+            data[i + 1] = kl::random::to_float( uint32_t( value ) ) * range + start_inclusive;
+    }
+}
+
+static constexpr uint32_t philox_multipliers[2] = { 0xD2511F53, 0xCD9E8D57 };
+static constexpr uint32_t philox_weyl[2] = { 0x9E3779B9, 0xBB67AE85 };
+
+static void set_block_index( std::array<uint32_t, 4>& counter, uint64_t index )
+{
+    counter[0] = uint32_t( index );
+    counter[1] = uint32_t( index >> 32 );
+}
+
+static uint64_t block_index( std::array<uint32_t, 4> const& counter )
+{
+    return counter[0] | (uint64_t( counter[1] ) << 32);
+}
+
+static __m256i mul_low_avx2( __m256i even, __m256i odd )
+{
+    return _mm256_blend_epi32( even, _mm256_slli_epi64( odd, 32 ), 0xAA );
+}
+
+static __m256i mul_high_avx2( __m256i even, __m256i odd )
+{
+    return _mm256_blend_epi32( _mm256_srli_epi64( even, 32 ), odd, 0xAA );
+}
+
+// Runs 8 consecutive blocks of one stream per iteration, one block per lane, then transposes them back to block order.
+static void philox_blocks_avx2( std::array<uint32_t, 2> const& key, std::array<uint32_t, 4> const& counter, uint32_t* output, uint64_t group_count )
+{
+    __m256i const multipliers[2] = { _mm256_set1_epi64x( philox_multipliers[0] ), _mm256_set1_epi64x( philox_multipliers[1] ) };
+    uint64_t const first_block = block_index( counter );
+    for ( uint64_t group = 0; group < group_count; group++, output += 32 )
+    {
+        alignas(32) uint32_t low_counters[8] = {};
+        alignas(32) uint32_t high_counters[8] = {};
+        for ( int lane = 0; lane < 8; lane++ )
+        {
+            uint64_t const index = first_block + group * 8 + lane;
+            low_counters[lane] = uint32_t( index );
+            high_counters[lane] = uint32_t( index >> 32 );
+        }
+
+        __m256i words[4] = {
+            _mm256_load_si256( (__m256i const*) low_counters ),
+            _mm256_load_si256( (__m256i const*) high_counters ),
+            _mm256_set1_epi32( int( counter[2] ) ),
+            _mm256_set1_epi32( int( counter[3] ) ),
+        };
+        uint32_t round_key[2] = { key[0], key[1] };
+        for ( int round = 0; round < 10; round++ )
+        {
+            __m256i const even0 = _mm256_mul_epu32( words[0], multipliers[0] );
+            __m256i const odd0 = _mm256_mul_epu32( _mm256_srli_epi64( words[0], 32 ), multipliers[0] );
+            __m256i const even1 = _mm256_mul_epu32( words[2], multipliers[1] );
+            __m256i const odd1 = _mm256_mul_epu32( _mm256_srli_epi64( words[2], 32 ), multipliers[1] );
+
+            words[0] = _mm256_xor_si256( _mm256_xor_si256( mul_high_avx2( even1, odd1 ), words[1] ), _mm256_set1_epi32( int( round_key[0] ) ) );
+            words[1] = mul_low_avx2( even1, odd1 );
+            words[2] = _mm256_xor_si256( _mm256_xor_si256( mul_high_avx2( even0, odd0 ), words[3] ), _mm256_set1_epi32( int( round_key[1] ) ) );
+            words[3] = mul_low_avx2( even0, odd0 );
+
+            round_key[0] += philox_weyl[0];
+            round_key[1] += philox_weyl[1];
+        }
+
+        __m256i const low[2] = { _mm256_unpacklo_epi32( words[0], words[1] ), _mm256_unpacklo_epi32( words[2], words[3] ) };
+        __m256i const high[2] = { _mm256_unpackhi_epi32( words[0], words[1] ), _mm256_unpackhi_epi32( words[2], words[3] ) };
+        __m256i const rows[4] = {
+            _mm256_unpacklo_epi64( low[0], low[1] ),
+            _mm256_unpackhi_epi64( low[0], low[1] ),
+            _mm256_unpacklo_epi64( high[0], high[1] ),
+            _mm256_unpackhi_epi64( high[0], high[1] ),
+        };
+        _mm256_storeu_si256( (__m256i*) output, _mm256_permute2x128_si256( rows[0], rows[1], 0x20 ) );
+        _mm256_storeu_si256( (__m256i*) (output + 8), _mm256_permute2x128_si256( rows[2], rows[3], 0x20 ) );
+        _mm256_storeu_si256( (__m256i*) (output + 16), _mm256_permute2x128_si256( rows[0], rows[1], 0x31 ) );
+        _mm256_storeu_si256( (__m256i*) (output + 24), _mm256_permute2x128_si256( rows[2], rows[3], 0x31 ) );
+    }
+}
+
+kl::Xoshiro256::Xoshiro256( uint64_t seed )
+{
+    for ( auto& value : state )
+        value = split_mix( seed );
+}
+
+void kl::Xoshiro256::jump()
+{
+    static constexpr uint64_t jump_table[4] = { 0x180EC6D33CFD0ABA, 0xD5A61266F0C9392C, 0xA9582618E03FC9AA, 0x39ABDC4529B1661C };
+
+    uint64_t result[4] = {};
+    for ( uint64_t jump : jump_table )
+    {
+        for ( int bit = 0; bit < 64; bit++ )
+        {
+            if ( jump & (uint64_t( 1 ) << bit) )
+            {
+                for ( int i = 0; i < 4; i++ )
+                    result[i] ^= state[i];
+            }
+            (*this)();
+        }
+    }
+    memcpy( state, result, sizeof( state ) );
+}
+
+kl::PCG64::PCG64( uint64_t seed, uint64_t stream )
+{
+    increment[0] = (stream << 1) | 1;
+    increment[1] = stream >> 63;
+    (*this)();
+    state[0] += seed;
+    state[1] += state[0] < seed;
+    (*this)();
+}
+
+kl::Philox::Philox( uint64_t seed, uint64_t stream )
+{
+    key = { uint32_t( seed ), uint32_t( seed >> 32 ) };
+    counter = { 0, 0, uint32_t( stream ), uint32_t( stream >> 32 ) };
+}
+
+kl::Philox::result_type kl::Philox::operator()()
+{
+    if ( m_index == 2 )
+    {
+        m_buffer = block( key, counter );
+        set_block_index( counter, block_index( counter ) + 1 );
+        m_index = 0;
+    }
+    uint32_t const index = m_index++;
+    return m_buffer[index * 2] | (uint64_t( m_buffer[index * 2 + 1] ) << 32);
+}
+
+uint64_t kl::Philox::position() const
+{
+    return block_index( counter ) * 2 - (2 - m_index);
+}
+
+void kl::Philox::seek( uint64_t position )
+{
+    set_block_index( counter, position / 2 );
+    m_index = 2;
+    if ( position % 2 != 0 )
+        (*this)();
+}
+
+void kl::Philox::fill( std::span<uint32_t> data )
+{
+    static bool const avx2 = cpu::has_avx2();
+
+    // Bulk output always starts on a whole block, a partially used block is skipped.
+    m_index = 2;
+    uint64_t const block_count = data.size() / 4;
+    uint64_t done_count = 0;
+    if ( avx2 )
+    {
+        uint64_t const group_count = block_count / 8;
+        philox_blocks_avx2( key, counter, data.data(), group_count );
+        done_count = group_count * 8;
+    }
+
+    uint64_t const first_block = block_index( counter );
+    std::array<uint32_t, 4> block_counter = counter;
+    for ( uint64_t i = done_count; i < block_count; i++ )
+    {
+        set_block_index( block_counter, first_block + i );
+        std::array<uint32_t, 4> const values = block( key, block_counter );
+        memcpy( data.data() + i * 4, values.data(), sizeof( values ) );
+    }
+
+    uint64_t const tail_size = data.size() % 4;
+    if ( tail_size > 0 )
+    {
+        set_block_index( block_counter, first_block + block_count );
+        std::array<uint32_t, 4> const values = block( key, block_counter );
+        memcpy( data.data() + block_count * 4, values.data(), tail_size * sizeof( uint32_t ) );
+    }
+    set_block_index( counter, first_block + block_count + (tail_size > 0) );
+}
+
+void kl::Philox::fill_floats( std::span<float> data, float start_inclusive, float end_inclusive )
+{
+    float const scale = (end_inclusive - start_inclusive) / 16777215.0f;
+    uint32_t bits[1024] = {};
+    for ( size_t offset = 0; offset < data.size(); offset += std::size( bits ) )
+    {
+        size_t const count = std::min( std::size( bits ), data.size() - offset );
+        fill( { bits, count } );
+        for ( size_t i = 0; i < count; i++ )
+            data[offset + i] = float( int32_t( bits[i] >> 8 ) ) * scale + start_inclusive;
+    }
+}
+
+std::array<uint32_t, 4> kl::Philox::block( std::array<uint32_t, 2> const& key, std::array<uint32_t, 4> const& counter )
+{
+    std::array<uint32_t, 4> words = counter;
+    uint32_t round_key[2] = { key[0], key[1] };
+    for ( int round = 0; round < 10; round++ )
+    {
+        uint64_t const product0 = uint64_t( philox_multipliers[0] ) * words[0];
+        uint64_t const product1 = uint64_t( philox_multipliers[1] ) * words[2];
+        words = {
+            uint32_t( product1 >> 32 ) ^ words[1] ^ round_key[0],
+            uint32_t( product1 ),
+            uint32_t( product0 >> 32 ) ^ words[3] ^ round_key[1],
+            uint32_t( product0 ),
+        };
+        round_key[0] += philox_weyl[0];
+        round_key[1] += philox_weyl[1];
+    }
+    return words;
+}
+
+kl::random::Engine& kl::random::engine()
+{
+    return _random_init;
+}
+
+void kl::random::seed( uint64_t seed )
+{
+    _random_init = Engine{ seed };
+}
+
 bool kl::random::gen_bool()
 {
-    return bool( _random_init() % 2 );
+    return bool( _random_init() >> 63 );
 }
 
 byte kl::random::gen_byte()
 {
-    return byte( _random_init() % 256 );
+    return byte( _random_init() >> 56 );
 }
 
 kl::RGB kl::random::gen_rgb( bool gray )
@@ -25,12 +349,13 @@ kl::RGB kl::random::gen_rgb( bool gray )
         byte rand_gray = gen_byte();
         return { rand_gray, rand_gray, rand_gray };
     }
-    return { gen_byte(), gen_byte(), gen_byte() };
+    uint64_t const value = _random_init();
+    return { byte( value >> 56 ), byte( value >> 48 ), byte( value >> 40 ) };
 }
 
 int kl::random::gen_int( int start_inclusive, int end_exclusive )
 {
-    return start_inclusive + (_random_init() % (end_exclusive - start_inclusive));
+    return start_inclusive + int( gen_bounded( _random_init, uint32_t( end_exclusive - start_inclusive ) ) );
 }
 
 int kl::random::gen_int( int end_exclusive )
@@ -60,99 +385,94 @@ float kl::random::gen_float( float end_inclusive )
 
 float kl::random::gen_float()
 {
-    return float( _random_init() ) / std::numeric_limits<uint32_t>::max();
+    return to_float( uint32_t( _random_init() >> 32 ) );
 }
 
 kl::Float2 kl::random::gen_float2( float start_inclusive, float end_inclusive )
 {
-    return { gen_float( start_inclusive, end_inclusive ), gen_float( start_inclusive, end_inclusive ) };
+    return gen_float2( end_inclusive - start_inclusive ) + Float2{ start_inclusive };
 }
 
 kl::Float2 kl::random::gen_float2( float end_inclusive )
 {
-    return { gen_float( end_inclusive ), gen_float( end_inclusive ) };
+    return gen_float2() * end_inclusive;
 }
 
 kl::Float2 kl::random::gen_float2()
 {
-    return { gen_float(), gen_float() };
+    uint64_t const value = _random_init();
+    return { to_float( uint32_t( value >> 32 ) ), to_float( uint32_t( value ) ) };
 }
 
 kl::Float3 kl::random::gen_float3( float start_inclusive, float end_inclusive )
 {
-    return { gen_float( start_inclusive, end_inclusive ), gen_float( start_inclusive, end_inclusive ), gen_float( start_inclusive, end_inclusive ) };
+    return gen_float3( end_inclusive - start_inclusive ) + Float3{ start_inclusive };
 }
 
 kl::Float3 kl::random::gen_float3( float end_inclusive )
 {
-    return { gen_float( end_inclusive ), gen_float( end_inclusive ), gen_float( end_inclusive ) };
+    return gen_float3() * end_inclusive;
 }
 
 kl::Float3 kl::random::gen_float3()
 {
-    return { gen_float(), gen_float(), gen_float() };
+    return { gen_float2(), gen_float() };
 }
 
 kl::Float4 kl::random::gen_float4( float start_inclusive, float end_inclusive )
 {
-    return { gen_float( start_inclusive, end_inclusive ), gen_float( start_inclusive, end_inclusive ), gen_float( start_inclusive, end_inclusive ), gen_float( start_inclusive, end_inclusive ) };
+    return gen_float4( end_inclusive - start_inclusive ) + Float4{ start_inclusive };
 }
 
 kl::Float4 kl::random::gen_float4( float end_inclusive )
 {
-    return { gen_float( end_inclusive ), gen_float( end_inclusive ), gen_float( end_inclusive ), gen_float( end_inclusive ) };
+    return gen_float4() * end_inclusive;
 }
 
 kl::Float4 kl::random::gen_float4()
 {
-    return { gen_float(), gen_float(), gen_float(), gen_float() };
+    return { gen_float2(), gen_float2() };
 }
 
 kl::Float3x3 kl::random::gen_float3x3( float start_inclusive, float end_inclusive )
 {
     Float3x3 result;
-    for ( auto& value : result.data )
-        value = gen_float( start_inclusive, end_inclusive );
+    fill_floats( result.data, start_inclusive, end_inclusive );
     return result;
 }
 
 kl::Float3x3 kl::random::gen_float3x3( float end_inclusive )
 {
     Float3x3 result;
-    for ( auto& value : result.data )
-        value = gen_float( end_inclusive );
+    fill_floats( result.data, 0.0f, end_inclusive );
     return result;
 }
 
 kl::Float3x3 kl::random::gen_float3x3()
 {
     Float3x3 result;
-    for ( auto& value : result.data )
-        value = gen_float();
+    fill_floats( result.data );
     return result;
 }
 
 kl::Float4x4 kl::random::gen_float4x4( float start_inclusive, float end_inclusive )
 {
     Float4x4 result;
-    for ( auto& value : result.data )
-        value = gen_float( start_inclusive, end_inclusive );
+    fill_floats( result.data, start_inclusive, end_inclusive );
     return result;
 }
 
 kl::Float4x4 kl::random::gen_float4x4( float end_inclusive )
 {
     Float4x4 result;
-    for ( auto& value : result.data )
-        value = gen_float( end_inclusive );
+    fill_floats( result.data, 0.0f, end_inclusive );
     return result;
 }
 
 kl::Float4x4 kl::random::gen_float4x4()
 {
     Float4x4 result;
-    for ( auto& value : result.data )
-        value = gen_float();
+    fill_floats( result.data );
     return result;
 }
 
@@ -171,3 +491,60 @@ std::string kl::random::gen_string( int length, bool upper )
         value = gen_char( upper );
     return result;
 }
+
+void kl::random::fill_bytes( std::span<byte> data )
+{
+    uint64_t const step_count = data.size() >= BULK_MIN_SIZE ? data.size() / 32 : 0;
+    if ( step_count > 0 )
+    {
+        static bool const avx2 = cpu::has_avx2();
+        BulkEngine bulk{ _random_init };
+        if ( avx2 )
+        {
+            bulk.run_avx2( step_count, [&]( uint64_t step, __m256i values )
+            {
+                _mm256_storeu_si256( (__m256i*) (data.data() + step * 32), values );
+            } );
+        }
+        else
+        {
+            bulk.run_scalar( step_count, [&]( uint64_t step, uint64_t const* values )
+            {
+                memcpy( data.data() + step * 32, values, 32 );
+            } );
+        }
+    }
+
+    for ( uint64_t i = step_count * 32; i < data.size(); i += 8 )
+    {
+        uint64_t const value = _random_init();
+        memcpy( data.data() + i, &value, std::min<uint64_t>( 8, data.size() - i ) );
+    }
+}
+
+void kl::random::fill_ints( std::span<int> data, int start_inclusive, int end_exclusive )
+{
+    uint32_t const range = uint32_t( end_exclusive - start_inclusive );
+    for ( auto& value : data )
+        value = start_inclusive + int( gen_bounded( _random_init, range ) );
+}
+
+void kl::random::fill_floats( std::span<float> data, float start_inclusive, float end_inclusive )
+{
+    fill_float_values( data.data(), data.size(), start_inclusive, end_inclusive );
+}
+
+void kl::random::fill_float2( std::span<Float2> data, float start_inclusive, float end_inclusive )
+{
+    fill_float_values( reinterpret_cast<float*>(data.data()), data.size() * 2, start_inclusive, end_inclusive );
+}
+
+void kl::random::fill_float3( std::span<Float3> data, float start_inclusive, float end_inclusive )
+{
+    fill_float_values( reinterpret_cast<float*>(data.data()), data.size() * 3, start_inclusive, end_inclusive );
+}
+
+void kl::random::fill_float4( std::span<Float4> data, float start_inclusive, float end_inclusive )
+{
+    fill_float_values( reinterpret_cast<float*>(data.data()), data.size() * 4, start_inclusive, end_inclusive );
+}
@@ -3,6 +3,163 @@
 #include "math/math.h"
 
 
+namespace kl
+{
+// xoshiro256++, 32 bytes of state. jump() skips 2^128 draws, which gives non-overlapping streams.
+struct Xoshiro256
+{
+    using result_type = uint64_t;
+
+    uint64_t state[4] = {};
+
+    Xoshiro256( uint64_t seed = 0 );
+
+    static constexpr result_type min()
+    {
+        return 0;
+    }
+
+    static constexpr result_type max()
+    {
+        return ~result_type( 0 );
+    }
+
+    result_type operator()()
+    {
+        uint64_t const result = std::rotl( state[0] + state[3], 23 ) + state[0];
+        uint64_t const shifted = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= shifted;
+        state[3] = std::rotl( state[3], 45 );
+        return result;
+    }
+
+    void jump();
+};
+
+// PCG64 with the DXSM output permutation, 128 bit state and a selectable stream.
+struct PCG64
+{
+    using result_type = uint64_t;
+
+    uint64_t state[2] = {};
+    uint64_t increment[2] = {};
+
+    PCG64( uint64_t seed = 0, uint64_t stream = 0 );
+
+    static constexpr result_type min()
+    {
+        return 0;
+    }
+
+    static constexpr result_type max()
+    {
+        return ~result_type( 0 );
+    }
+
+    result_type operator()()
+    {
+        static constexpr uint64_t multiplier = 0xDA942042E4DD58B5;
+
+        uint64_t high = state[1];
+        high ^= high >> 32;
+        high *= multiplier;
+        high ^= high >> 48;
+        high *= state[0] | 1;
+
+        uint64_t carry = 0;
+        uint64_t const low = _umul128( state[0], multiplier, &carry );
+        state[1] = state[1] * multiplier + carry + increment[1];
+        state[0] = low + increment[0];
+        state[1] += state[0] < low;
+        return high;
+    }
+};
+}
+
+namespace kl
+{
+// Philox4x32-10, a counter based generator. Every output is a pure function of the seed, the stream
+// and the position, so parallel loops can take stream = index and stay bit-identical on any core count.
+struct Philox
+{
+    using result_type = uint64_t;
+
+    std::array<uint32_t, 2> key = {};
+    std::array<uint32_t, 4> counter = {};
+
+    Philox( uint64_t seed = 0, uint64_t stream = 0 );
+
+    static constexpr result_type min()
+    {
+        return 0;
+    }
+
+    static constexpr result_type max()
+    {
+        return ~result_type( 0 );
+    }
+
+    result_type operator()();
+
+    uint64_t position() const;
+    void seek( uint64_t position );
+
+    void fill( std::span<uint32_t> data );
+    void fill_floats( std::span<float> data, float start_inclusive = 0.0f, float end_inclusive = 1.0f );
+
+    static std::array<uint32_t, 4> block( std::array<uint32_t, 2> const& key, std::array<uint32_t, 4> const& counter );
+
+private:
+    std::array<uint32_t, 4> m_buffer = {};
+    uint32_t m_index = 2;
+};
+}
+
+namespace kl::random
+{
+using Engine = Xoshiro256;
+
+Engine& engine();
+void seed( uint64_t seed );
+
+// Lemire's multiply-shift, the rare rejections remove the bias of a plain modulo.
+template<typename E>
+uint32_t gen_bounded( E& engine, uint32_t range )
+{
+    uint64_t product = (engine() >> 32) * range;
+    if ( uint32_t( product ) < range )
+    {
+        uint32_t const threshold = uint32_t( -int64_t( range ) ) % range;
+        while ( uint32_t( product ) < threshold )
+            product = (engine() >> 32) * range;
+    }
+    return uint32_t( product >> 32 );
+}
+
+template<typename E>
+uint64_t gen_bounded64( E& engine, uint64_t range )
+{
+    uint64_t high = 0;
+    uint64_t low = _umul128( engine(), range, &high );
+    if ( low < range )
+    {
+        uint64_t const threshold = (0 - range) % range;
+        while ( low < threshold )
+            low = _umul128( engine(), range, &high );
+    }
+    return high;
+}
+
+inline float to_float( uint32_t bits )
+{
+    return float( bits >> 8 ) / 16777215.0f;
+}
+}
+
 namespace kl::random
 {
 bool gen_bool();
@@ -42,3 +199,14 @@ Float4x4 gen_float4x4();
 char gen_char( bool upper = false );
 std::string gen_string( int length, bool upper = false );
 }
+
+namespace kl::random
+{
+void fill_bytes( std::span<byte> data );
+void fill_ints( std::span<int> data, int start_inclusive, int end_exclusive );
+
+void fill_floats( std::span<float> data, float start_inclusive = 0.0f, float end_inclusive = 1.0f );
+void fill_float2( std::span<Float2> data, float start_inclusive = 0.0f, float end_inclusive = 1.0f );
+void fill_float3( std::span<Float3> data, float start_inclusive = 0.0f, float end_inclusive = 1.0f );
+void fill_float4( std::span<Float4> data, float start_inclusive = 0.0f, float end_inclusive = 1.0f );
+}
@@ -1,13 +1,18 @@
 #pragma once
 
-#include "apis/apis.h"
+#include "utility/hash/fast_hash.h"
 
 
 namespace kl
 {
-struct string_hash : std::hash<std::string_view>
+struct string_hash
 {
     using is_transparent = void;
+
+    constexpr size_t operator()( std::string_view const& data ) const
+    {
+        return hash_str_fast( data );
+    }
 };
 }
 
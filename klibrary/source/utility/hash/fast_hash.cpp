@@ -0,0 +1,50 @@
+#include "klibrary.h"
+
+
+static void accumulate_avx2( char const* data, uint64_t block_count, uint64_t const* keys, uint64_t* accumulators )
+{
+    __m256i const prime = _mm256_set1_epi64x( 0x9E3779B1 );
+    __m256i values[2] = {
+        _mm256_loadu_si256( (__m256i const*) accumulators ),
+        _mm256_loadu_si256( (__m256i const*) (accumulators + 4) ),
+    };
+    for ( uint64_t block = 0; block < block_count; block++ )
+    {
+        for ( int stripe = 0; stripe < 16; stripe++ )
+        {
+            char const* stripe_data = data + block * kl::FastHash::BULK_SIZE + stripe * 64;
+            for ( int half = 0; half < 2; half++ )
+            {
+                __m256i const value = _mm256_loadu_si256( (__m256i const*) (stripe_data + half * 32) );
+                __m256i const keyed = _mm256_xor_si256( value, _mm256_loadu_si256( (__m256i const*) (keys + stripe + half * 4) ) );
+                __m256i const product = _mm256_mul_epu32( keyed, _mm256_srli_epi64( keyed, 32 ) );
+                __m256i const swapped = _mm256_shuffle_epi32( value, _MM_SHUFFLE( 1, 0, 3, 2 ) );
+                values[half] = _mm256_add_epi64( values[half], _mm256_add_epi64( product, swapped ) );
+            }
+        }
+        for ( int half = 0; half < 2; half++ )
+        {
+            __m256i value = values[half];
+            value = _mm256_xor_si256( value, _mm256_srli_epi64( value, 47 ) );
+            value = _mm256_xor_si256( value, _mm256_loadu_si256( (__m256i const*) (keys + 24 + half * 4) ) );
+            __m256i const low = _mm256_mul_epu32( value, prime );
+            __m256i const high = _mm256_mul_epu32( _mm256_srli_epi64( value, 32 ), prime );
+            values[half] = _mm256_add_epi64( low, _mm256_slli_epi64( high, 32 ) );
+        }
+    }
+    _mm256_storeu_si256( (__m256i*) accumulators, values[0] );
+    _mm256_storeu_si256( (__m256i*) (accumulators + 4), values[1] );
+}
+
+void kl::FastHash::accumulate( char const* data, uint64_t block_count, uint64_t* accumulators )
+{
+    static bool const avx2 = cpu::has_avx2();
+    if ( avx2 )
+    {
+        accumulate_avx2( data, block_count, KEYS.data(), accumulators );
+    }
+    else
+    {
+        accumulate_scalar( data, block_count, accumulators );
+    }
+}
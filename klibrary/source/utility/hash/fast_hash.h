@@ -0,0 +1,223 @@
+#pragma once
+
+#include "apis/apis.h"
+
+
+namespace kl
+{
+struct Hash128
+{
+    uint64_t low = 0;
+    uint64_t high = 0;
+
+    constexpr bool operator==( Hash128 const& other ) const = default;
+};
+}
+
+namespace kl
+{
+// Non-cryptographic 64 bit hash in the wyhash family. Inputs of BULK_SIZE bytes and more first
+// go through an 8 lane stripe accumulator that runs on AVX2 when available, with identical results.
+struct FastHash
+{
+    static constexpr uint64_t BULK_SIZE = 1024;
+
+    static constexpr uint64_t hash( char const* data, uint64_t byte_size, uint64_t seed )
+    {
+        seed ^= mix( seed ^ SECRET[0], SECRET[1] );
+
+        uint64_t a = 0;
+        uint64_t b = 0;
+        if ( byte_size <= 16 )
+        {
+            if ( byte_size >= 4 )
+            {
+                uint64_t const shift = (byte_size >> 3) << 2;
+                a = (read4( data ) << 32) | read4( data + shift );
+                b = (read4( data + byte_size - 4 ) << 32) | read4( data + byte_size - 4 - shift );
+            }
+            else if ( byte_size > 0 )
+            {
+                a = (uint64_t( uint8_t( data[0] ) ) << 16) | (uint64_t( uint8_t( data[byte_size >> 1] ) ) << 8) | uint8_t( data[byte_size - 1] );
+            }
+        }
+        else
+        {
+            char const* position = data;
+            uint64_t remaining = byte_size;
+            if ( remaining >= BULK_SIZE )
+            {
+                uint64_t const block_count = remaining / BULK_SIZE;
+                uint64_t accumulators[8] = { 0xC2B2AE3D, 0x9E3779B185EBCA87, 0xC2B2AE3D27D4EB4F, 0x165667B19E3779F9,
+                    0x85EBCA77C2B2AE63, 0x85EBCA77, 0x27D4EB2F165667C5, 0x9E3779B1 };
+                if ( std::is_constant_evaluated() )
+                    accumulate_scalar( position, block_count, accumulators );
+                else
+                    accumulate( position, block_count, accumulators );
+
+                uint64_t folded = byte_size * 0x9E3779B185EBCA87;
+                for ( int i = 0; i < 4; i++ )
+                    folded += mix( accumulators[i * 2] ^ KEYS[i * 2], accumulators[i * 2 + 1] ^ KEYS[i * 2 + 1] );
+                seed = mix( seed ^ folded, SECRET[2] );
+                position += block_count * BULK_SIZE;
+                remaining -= block_count * BULK_SIZE;
+            }
+            if ( remaining > 48 )
+            {
+                uint64_t first_seed = seed;
+                uint64_t second_seed = seed;
+                do
+                {
+                    seed = mix( read8( position ) ^ SECRET[1], read8( position + 8 ) ^ seed );
+                    first_seed = mix( read8( position + 16 ) ^ SECRET[2], read8( position + 24 ) ^ first_seed );
+                    second_seed = mix( read8( position + 32 ) ^ SECRET[3], read8( position + 40 ) ^ second_seed );
+                    position += 48;
+                    remaining -= 48;
+                }
+                while ( remaining > 48 );
+                seed ^= first_seed ^ second_seed;
+            }
+            while ( remaining > 16 )
+            {
+                seed = mix( read8( position ) ^ SECRET[1], read8( position + 8 ) ^ seed );
+                position += 16;
+                remaining -= 16;
+            }
+            a = read8( position + remaining - 16 );
+            b = read8( position + remaining - 8 );
+        }
+
+        a ^= SECRET[1];
+        b ^= seed;
+        multiply( a, b );
+        return mix( a ^ SECRET[0] ^ byte_size, b ^ SECRET[1] );
+    }
+
+    static constexpr Hash128 hash128( char const* data, uint64_t byte_size, uint64_t seed )
+    {
+        return { hash( data, byte_size, seed ), hash( data, byte_size, seed ^ SECRET[3] ) };
+    }
+
+private:
+    static constexpr uint64_t SECRET[4] = { 0x2d358dccaa6c78a5, 0x8bb84b93962eacc9, 0x4b33a62ed433d4a3, 0x4d5a2da51de1aa47 };
+
+    // Stripe s mixes lane i with KEYS[s + i], the scramble after every block uses KEYS[24 + i].
+    static constexpr std::array<uint64_t, 32> KEYS = []
+    {
+        std::array<uint64_t, 32> result = {};
+        uint64_t state = 0x9E3779B97F4A7C15;
+        for ( auto& key : result )
+        {
+            state += 0x9E3779B97F4A7C15;
+            uint64_t value = state;
+            value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+            value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+            key = value ^ (value >> 31);
+        }
+        return result;
+    }();
+
+    static constexpr uint64_t read8( char const* data )
+    {
+        if ( std::is_constant_evaluated() )
+        {
+            uint64_t result = 0;
+            for ( int i = 0; i < 8; i++ )
+                result |= uint64_t( uint8_t( data[i] ) ) << (i * 8);
+            return result;
+        }
+        uint64_t result = 0;
+        memcpy( &result, data, sizeof( result ) );
+        return result;
+    }
+
+    static constexpr uint64_t read4( char const* data )
+    {
+        if ( std::is_constant_evaluated() )
+        {
+            uint64_t result = 0;
+            for ( int i = 0; i < 4; i++ )
+                result |= uint64_t( uint8_t( data[i] ) ) << (i * 8);
+            return result;
+        }
+        uint32_t result = 0;
+        memcpy( &result, data, sizeof( result ) );
+        return result;
+    }
+
+    static constexpr void multiply( uint64_t& a, uint64_t& b )
+    {
+        if ( std::is_constant_evaluated() )
+        {
+            uint64_t const low_low = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+            uint64_t const low_high = (a & 0xFFFFFFFF) * (b >> 32);
+            uint64_t const high_low = (a >> 32) * (b & 0xFFFFFFFF);
+            uint64_t const high_high = (a >> 32) * (b >> 32);
+            uint64_t const middle = (low_low >> 32) + (low_high & 0xFFFFFFFF) + (high_low & 0xFFFFFFFF);
+            a = (middle << 32) | (low_low & 0xFFFFFFFF);
+            b = high_high + (low_high >> 32) + (high_low >> 32) + (middle >> 32);
+            return;
+        }
+        uint64_t high = 0;
+        a = _umul128( a, b, &high );
+        b = high;
+    }
+
+    static constexpr uint64_t mix( uint64_t a, uint64_t b )
+    {
+        multiply( a, b );
+        return a ^ b;
+    }
+
+    static constexpr void accumulate_scalar( char const* data, uint64_t block_count, uint64_t* accumulators )
+    {
+        for ( uint64_t block = 0; block < block_count; block++ )
+        {
+            for ( int stripe = 0; stripe < 16; stripe++ )
+            {
+                char const* stripe_data = data + block * BULK_SIZE + stripe * 64;
+                for ( int i = 0; i < 8; i++ )
+                {
+                    uint64_t const value = read8( stripe_data + i * 8 );
+                    uint64_t const keyed = value ^ KEYS[stripe + i];
+                    accumulators[i ^ 1] += value;
+                    accumulators[i] += (keyed & 0xFFFFFFFF) * (keyed >> 32);
+                }
+            }
+            for ( int i = 0; i < 8; i++ )
+            {
+                uint64_t value = accumulators[i];
+                value ^= value >> 47;
+                value ^= KEYS[24 + i];
+                accumulators[i] = value * 0x9E3779B1;
+            }
+        }
+    }
+
+    static void accumulate( char const* data, uint64_t block_count, uint64_t* accumulators );
+};
+}
+
+namespace kl
+{
+inline uint64_t hash_fast( void const* data, uint64_t byte_size, uint64_t seed = 0 )
+{
+    return FastHash::hash( reinterpret_cast<char const*>(data), byte_size, seed );
+}
+
+inline Hash128 hash128_fast( void const* data, uint64_t byte_size, uint64_t seed = 0 )
+{
+    return FastHash::hash128( reinterpret_cast<char const*>(data), byte_size, seed );
+}
+
+constexpr uint64_t hash_str_fast( std::string_view const& data, uint64_t seed = 0 )
+{
+    return FastHash::hash( data.data(), data.size(), seed );
+}
+
+template<typename T>
+uint64_t hash_obj_fast( T const& object, uint64_t seed = 0 )
+{
+    return hash_fast( &object, sizeof( T ), seed );
+}
+}
@@ -11,142 +11,416 @@
 #define SIG0(x) (ROTRIGHT(x, 7) ^ ROTRIGHT(x, 18) ^ ((x) >> 3))
 #define SIG1(x) (ROTRIGHT(x, 17) ^ ROTRIGHT(x, 19) ^ ((x) >> 10))
 
-struct SHA256Context
+alignas(16) static constexpr uint32_t hash_keys[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static constexpr uint32_t initial_state[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+static void store_state( uint32_t const* state, kl::Hash& result )
+{
+    for ( uint32_t i = 0; i < 8; i++ )
+    {
+        result[i * 4] = uint8_t( state[i] >> 24 );
+        result[i * 4 + 1] = uint8_t( state[i] >> 16 );
+        result[i * 4 + 2] = uint8_t( state[i] >> 8 );
+        result[i * 4 + 3] = uint8_t( state[i] );
+    }
+}
+
+// Writes the 0x80 terminator, zero padding and the bit length, returns the block count.
+static uint64_t pad_tail( uint8_t* tail, uint64_t tail_size, uint64_t byte_size )
 {
-    uint8_t data[64] = {};
-    uint8_t data_length = {};
-    uint32_t state[8] = {};
-    uint32_t bit_length[2] = {};
+    uint64_t const block_count = tail_size < 56 ? 1 : 2;
+    tail[tail_size] = 0x80;
+    memset( tail + tail_size + 1, 0, block_count * 64 - tail_size - 1 );
+
+    uint64_t const bit_length = byte_size * 8;
+    for ( uint64_t i = 0; i < 8; i++ )
+        tail[block_count * 64 - 1 - i] = uint8_t( bit_length >> (i * 8) );
+    return block_count;
+}
 
-    constexpr SHA256Context()
+static void compress_scalar( uint32_t* context_state, uint8_t const* data, uint64_t block_count )
+{
+    for ( ; block_count > 0; block_count--, data += 64 )
     {
-        state[0] = 0x6a09e667;
-        state[1] = 0xbb67ae85;
-        state[2] = 0x3c6ef372;
-        state[3] = 0xa54ff53a;
-        state[4] = 0x510e527f;
-        state[5] = 0x9b05688c;
-        state[6] = 0x1f83d9ab;
-        state[7] = 0x5be0cd19;
+        uint32_t padded[64] = {};
+        for ( uint8_t i = 0; i < 16; i++ )
+            padded[i] = (data[i * 4] << 24) | (data[i * 4 + 1] << 16) | (data[i * 4 + 2] << 8) | (data[i * 4 + 3]);
+        for ( uint8_t i = 16; i < 64; i++ )
+            padded[i] = SIG1( padded[i - 2] ) + padded[i - 7] + SIG0( padded[i - 15] ) + padded[i - 16];
+
+        uint32_t t[2] = {};
+        uint32_t state[8] = {
+            context_state[0],
+            context_state[1],
+            context_state[2],
+            context_state[3],
+            context_state[4],
+            context_state[5],
+            context_state[6],
+            context_state[7],
+        };
+        for ( uint8_t i = 0; i < 64; i++ )
+        {
+            t[0] = state[7] + EP1( state[4] ) + CH( state[4], state[5], state[6] ) + padded[i] + hash_keys[i];
+            t[1] = EP0( state[0] ) + MAJ( state[0], state[1], state[2] );
+            state[7] = state[6];
+            state[6] = state[5];
+            state[5] = state[4];
+            state[4] = state[3] + t[0];
+            state[3] = state[2];
+            state[2] = state[1];
+            state[1] = state[0];
+            state[0] = t[0] + t[1];
+        }
+        for ( uint8_t i = 0; i < 8; i++ )
+            context_state[i] += state[i];
     }
-};
+}
 
-static void transform_context( SHA256Context& context, uint8_t const* data )
-{
-    static uint32_t hash_keys[64] = {
-        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
-        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
-        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
-        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
-    };
+static void compress_sha( uint32_t* context_state, uint8_t const* data, uint64_t block_count )
+{
+    __m128i const byte_swap = _mm_set_epi64x( 0x0c0d0e0f08090a0bull, 0x0405060700010203ull );
 
-    uint32_t padded[64] = {};
-    for ( uint8_t i = 0; i < 16; i++ )
-        padded[i] = (data[i * 4] << 24) | (data[i * 4 + 1] << 16) | (data[i * 4 + 2] << 8) | (data[i * 4 + 3]);
-    for ( uint8_t i = 16; i < 64; i++ )
-        padded[i] = SIG1( padded[i - 2] ) + padded[i - 7] + SIG0( padded[i - 15] ) + padded[i - 16];
-
-    uint32_t t[2] = {};
-    uint32_t state[8] = {
-        context.state[0],
-        context.state[1],
-        context.state[2],
-        context.state[3],
-        context.state[4],
-        context.state[5],
-        context.state[6],
-        context.state[7],
-    };
-    for ( uint8_t i = 0; i < 64; i++ )
+    // The SHA instructions keep the state as ABEF and CDGH pairs.
+    __m128i swapped = _mm_shuffle_epi32( _mm_loadu_si128( (__m128i const*) context_state ), 0xB1 );
+    __m128i state1 = _mm_shuffle_epi32( _mm_loadu_si128( (__m128i const*) (context_state + 4) ), 0x1B );
+    __m128i state0 = _mm_alignr_epi8( swapped, state1, 8 );
+    state1 = _mm_blend_epi16( state1, swapped, 0xF0 );
+
+    for ( ; block_count > 0; block_count--, data += 64 )
     {
-        t[0] = state[7] + EP1( state[4] ) + CH( state[4], state[5], state[6] ) + padded[i] + hash_keys[i];
-        t[1] = EP0( state[0] ) + MAJ( state[0], state[1], state[2] );
+        __m128i const saved0 = state0;
+        __m128i const saved1 = state1;
+        __m128i messages[4] = {};
+        for ( int i = 0; i < 16; i++ )
+        {
+            __m128i& message = messages[i & 3];
+            if ( i < 4 )
+            {
+                message = _mm_shuffle_epi8( _mm_loadu_si128( (__m128i const*) (data + i * 16) ), byte_swap );
+            }
+            else
+            {
+                __m128i const previous = messages[(i - 1) & 3];
+                __m128i const partial = _mm_add_epi32( _mm_sha256msg1_epu32( message, messages[(i - 3) & 3] ),
+                    _mm_alignr_epi8( previous, messages[(i - 2) & 3], 4 ) );
+                message = _mm_sha256msg2_epu32( partial, previous );
+            }
+            __m128i const keyed = _mm_add_epi32( message, _mm_load_si128( (__m128i const*) (hash_keys + i * 4) ) );
+            state1 = _mm_sha256rnds2_epu32( state1, state0, keyed );
+            state0 = _mm_sha256rnds2_epu32( state0, state1, _mm_shuffle_epi32( keyed, 0x0E ) );
+        }
+        state0 = _mm_add_epi32( state0, saved0 );
+        state1 = _mm_add_epi32( state1, saved1 );
+    }
+
+    swapped = _mm_shuffle_epi32( state0, 0x1B );
+    state1 = _mm_shuffle_epi32( state1, 0xB1 );
+    _mm_storeu_si128( (__m128i*) context_state, _mm_blend_epi16( swapped, state1, 0xF0 ) );
+    _mm_storeu_si128( (__m128i*) (context_state + 4), _mm_alignr_epi8( state1, swapped, 8 ) );
+}
+
+static __m256i rotate_lanes( __m256i value, int count )
+{
+    return _mm256_or_si256( _mm256_srli_epi32( value, count ), _mm256_slli_epi32( value, 32 - count ) );
+}
+
+// Loads 32 bytes from each of the 8 blocks and transposes them so word i of every lane ends up in words[i].
+static void load_lanes( uint8_t const* const* blocks, size_t offset, __m256i* words )
+{
+    __m256i const byte_swap = _mm256_setr_epi8( 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 );
+
+    __m256i rows[8] = {};
+    for ( int i = 0; i < 8; i++ )
+        rows[i] = _mm256_shuffle_epi8( _mm256_loadu_si256( (__m256i const*) (blocks[i] + offset) ), byte_swap );
+
+    __m256i pairs[8] = {};
+    for ( int i = 0; i < 8; i += 2 )
+    {
+        pairs[i] = _mm256_unpacklo_epi32( rows[i], rows[i + 1] );
+        pairs[i + 1] = _mm256_unpackhi_epi32( rows[i], rows[i + 1] );
+    }
+    __m256i quads[8] = {};
+    for ( int i = 0; i < 8; i += 4 )
+    {
+        quads[i] = _mm256_unpacklo_epi64( pairs[i], pairs[i + 2] );
+        quads[i + 1] = _mm256_unpackhi_epi64( pairs[i], pairs[i + 2] );
+        quads[i + 2] = _mm256_unpacklo_epi64( pairs[i + 1], pairs[i + 3] );
+        quads[i + 3] = _mm256_unpackhi_epi64( pairs[i + 1], pairs[i + 3] );
+    }
+    for ( int i = 0; i < 4; i++ )
+    {
+        words[i] = _mm256_permute2x128_si256( quads[i], quads[i + 4], 0x20 );
+        words[i + 4] = _mm256_permute2x128_si256( quads[i], quads[i + 4], 0x31 );
+    }
+}
+
+static void compress_lanes( __m256i* context_state, uint8_t const* const* blocks )
+{
+    __m256i padded[16] = {};
+    load_lanes( blocks, 0, padded );
+    load_lanes( blocks, 32, padded + 8 );
+
+    __m256i state[8] = {};
+    for ( int i = 0; i < 8; i++ )
+        state[i] = context_state[i];
+
+    for ( int i = 0; i < 64; i++ )
+    {
+        __m256i& word = padded[i & 15];
+        if ( i >= 16 )
+        {
+            __m256i const early = padded[(i - 15) & 15];
+            __m256i const late = padded[(i - 2) & 15];
+            __m256i const sig0 = _mm256_xor_si256( _mm256_xor_si256( rotate_lanes( early, 7 ), rotate_lanes( early, 18 ) ), _mm256_srli_epi32( early, 3 ) );
+            __m256i const sig1 = _mm256_xor_si256( _mm256_xor_si256( rotate_lanes( late, 17 ), rotate_lanes( late, 19 ) ), _mm256_srli_epi32( late, 10 ) );
+            word = _mm256_add_epi32( _mm256_add_epi32( word, sig0 ), _mm256_add_epi32( padded[(i - 7) & 15], sig1 ) );
+        }
+
+        __m256i const ep1 = _mm256_xor_si256( _mm256_xor_si256( rotate_lanes( state[4], 6 ), rotate_lanes( state[4], 11 ) ), rotate_lanes( state[4], 25 ) );
+        __m256i const ch = _mm256_xor_si256( _mm256_and_si256( state[4], state[5] ), _mm256_andnot_si256( state[4], state[6] ) );
+        __m256i const t0 = _mm256_add_epi32( _mm256_add_epi32( state[7], ep1 ),
+            _mm256_add_epi32( ch, _mm256_add_epi32( word, _mm256_set1_epi32( hash_keys[i] ) ) ) );
+
+        __m256i const ep0 = _mm256_xor_si256( _mm256_xor_si256( rotate_lanes( state[0], 2 ), rotate_lanes( state[0], 13 ) ), rotate_lanes( state[0], 22 ) );
+        __m256i const maj = _mm256_or_si256( _mm256_and_si256( state[0], state[1] ), _mm256_and_si256( state[2], _mm256_or_si256( state[0], state[1] ) ) );
+        __m256i const t1 = _mm256_add_epi32( ep0, maj );
+
         state[7] = state[6];
         state[6] = state[5];
         state[5] = state[4];
-        state[4] = state[3] + t[0];
+        state[4] = _mm256_add_epi32( state[3], t0 );
         state[3] = state[2];
         state[2] = state[1];
         state[1] = state[0];
-        state[0] = t[0] + t[1];
+        state[0] = _mm256_add_epi32( t0, t1 );
     }
-    for ( uint8_t i = 0; i < 8; i++ )
-        context.state[i] += state[i];
+    for ( int i = 0; i < 8; i++ )
+        context_state[i] = _mm256_add_epi32( context_state[i], state[i] );
 }
 
-static void update_context( SHA256Context& context, uint8_t const* data, uint64_t data_size )
+// Hashes up to 8 messages together, shorter messages keep their state once their blocks run out.
+static void hash_lanes( std::string_view const* const* messages, size_t count, kl::Hash* const* results )
 {
-    for ( uint64_t i = 0; i < data_size; ++i )
+    struct Lane
     {
-        context.data[context.data_length] = data[i];
-        context.data_length += 1;
+        uint8_t const* data = nullptr;
+        uint64_t full_blocks = 0;
+        uint64_t block_count = 0;
+        uint8_t tail[128] = {};
+    };
 
-        if ( context.data_length == 64 )
-        {
-            transform_context( context, context.data );
-            if ( context.bit_length[0] > ( 0xffffffff - 512 ) )
-                context.bit_length[1] += 1;
+    Lane lanes[8] = {};
+    uint64_t max_blocks = 0;
+    for ( size_t i = 0; i < 8; i++ )
+    {
+        std::string_view const message = i < count ? *messages[i] : std::string_view{};
+        Lane& lane = lanes[i];
+        lane.data = reinterpret_cast<uint8_t const*>(message.data());
+        lane.full_blocks = message.size() / 64;
 
-            context.bit_length[0] += 512;
-            context.data_length = 0;
-        }
+        uint64_t const tail_size = message.size() % 64;
+        if ( tail_size > 0 )
+            memcpy( lane.tail, lane.data + lane.full_blocks * 64, tail_size );
+        lane.block_count = lane.full_blocks + pad_tail( lane.tail, tail_size, message.size() );
+        max_blocks = std::max( max_blocks, lane.block_count );
     }
-}
 
-static kl::Hash finalize_context( SHA256Context& context )
-{
-    uint8_t index = context.data_length;
-    if ( context.data_length < 56 )
+    __m256i state[8] = {};
+    for ( int i = 0; i < 8; i++ )
+        state[i] = _mm256_set1_epi32( initial_state[i] );
+
+    uint8_t const* blocks[8] = {};
+    for ( uint64_t block = 0; block < max_blocks; block++ )
     {
-        context.data[index++] = 0x80;
-        while ( index < 56 )
-            context.data[index++] = 0;
+        alignas(32) int32_t active[8] = {};
+        for ( size_t i = 0; i < 8; i++ )
+        {
+            Lane const& lane = lanes[i];
+            if ( block < lane.full_blocks )
+                blocks[i] = lane.data + block * 64;
+            else if ( block < lane.block_count )
+                blocks[i] = lane.tail + (block - lane.full_blocks) * 64;
+            else
+                blocks[i] = lane.tail;
+            active[i] = block < lane.block_count ? -1 : 0;
+        }
+
+        __m256i saved[8] = {};
+        for ( int i = 0; i < 8; i++ )
+            saved[i] = state[i];
+        compress_lanes( state, blocks );
+
+        __m256i const mask = _mm256_load_si256( (__m256i const*) active );
+        for ( int i = 0; i < 8; i++ )
+            state[i] = _mm256_blendv_epi8( saved[i], state[i], mask );
     }
-    else
-    {
-        context.data[index++] = 0x80;
-        while ( index < 64 )
-            context.data[index++] = 0;
 
-        transform_context( context, context.data );
-        memset( context.data, 0, 56 );
+    alignas(32) uint32_t words[8][8] = {};
+    for ( int i = 0; i < 8; i++ )
+        _mm256_store_si256( (__m256i*) words[i], state[i] );
+    for ( size_t i = 0; i < count; i++ )
+    {
+        uint32_t lane_state[8] = {};
+        for ( int j = 0; j < 8; j++ )
+            lane_state[j] = words[j][i];
+        store_state( lane_state, *results[i] );
     }
+}
+
+// Callers can ask for a level on their own, its instructions would fault on a cpu that doesn't have them.
+static kl::HashLevel supported_level( kl::HashLevel level )
+{
+    bool const supported = level == kl::HashLevel::SCALAR
+        || (level == kl::HashLevel::AVX2 && kl::cpu::has_avx2())
+        || (level == kl::HashLevel::SHA && kl::cpu::has_sha());
+    return supported ? level : kl::Hasher::best_level();
+}
+
+kl::Hasher::Hasher()
+{
+    static HashLevel const level = best_level();
+    m_level = level;
+    reset();
+}
+
+kl::Hasher::Hasher( HashLevel level )
+    : m_level( supported_level( level ) )
+{
+    reset();
+}
+
+kl::HashLevel kl::Hasher::best_level()
+{
+    if ( cpu::has_sha() )
+        return HashLevel::SHA;
+    if ( cpu::has_avx2() )
+        return HashLevel::AVX2;
+    return HashLevel::SCALAR;
+}
+
+void kl::Hasher::update( void const* data, uint64_t byte_size )
+{
+    auto compress = m_level == HashLevel::SHA ? compress_sha : compress_scalar;
+    uint8_t const* bytes = reinterpret_cast<uint8_t const*>(data);
+    m_byte_size += byte_size;
 
-    if ( context.bit_length[0] > ( 0xffffffff - (context.data_length * 8) ) )
-        context.bit_length[1] += 1;
-    context.bit_length[0] += (context.data_length * 8);
-
-    context.data[63] = context.bit_length[0];
-    context.data[62] = context.bit_length[0] >> 8;
-    context.data[61] = context.bit_length[0] >> 16;
-    context.data[60] = context.bit_length[0] >> 24;
-    context.data[59] = context.bit_length[1];
-    context.data[58] = context.bit_length[1] >> 8;
-    context.data[57] = context.bit_length[1] >> 16;
-    context.data[56] = context.bit_length[1] >> 24;
-    transform_context( context, context.data );
-
-    kl::Hash result;
-    for ( uint32_t i = 0; i < 4; i++ )
+    if ( m_buffer_size > 0 )
     {
-        for ( uint32_t j = 0; j < 8; j++ )
-            result[i + ((size_t) j * 4)] = (context.state[j] >> (24 - (i * 8))) & 0x000000ff;
+        uint64_t const count = std::min( 64 - m_buffer_size, byte_size );
+        memcpy( m_buffer + m_buffer_size, bytes, count );
+        m_buffer_size += count;
+        bytes += count;
+        byte_size -= count;
+        if ( m_buffer_size < 64 )
+            return;
+
+        compress( m_state, m_buffer, 1 );
+        m_buffer_size = 0;
     }
+
+    uint64_t const block_count = byte_size / 64;
+    compress( m_state, bytes, block_count );
+    bytes += block_count * 64;
+    byte_size -= block_count * 64;
+
+    memcpy( m_buffer, bytes, byte_size );
+    m_buffer_size = byte_size;
+}
+
+void kl::Hasher::update( std::string_view const& data )
+{
+    update( data.data(), data.size() );
+}
+
+kl::Hash kl::Hasher::finalize()
+{
+    uint8_t tail[128] = {};
+    memcpy( tail, m_buffer, m_buffer_size );
+    uint64_t const block_count = pad_tail( tail, m_buffer_size, m_byte_size );
+    if ( m_level == HashLevel::SHA )
+        compress_sha( m_state, tail, block_count );
+    else
+        compress_scalar( m_state, tail, block_count );
+
+    Hash result;
+    store_state( m_state, result );
+    reset();
     return result;
 }
 
+void kl::Hasher::reset()
+{
+    memcpy( m_state, initial_state, sizeof( m_state ) );
+    m_buffer_size = 0;
+    m_byte_size = 0;
+}
+
 kl::Hash kl::hash( void const* data, uint64_t data_size )
 {
-    SHA256Context context{};
-    update_context( context, reinterpret_cast<uint8_t const*>(data), data_size );
-    return finalize_context( context );
+    Hasher hasher;
+    hasher.update( data, data_size );
+    return hasher.finalize();
 }
 
 kl::Hash kl::hash_str( std::string_view const& data )
 {
     return hash( data.data(), data.size() );
 }
+
+std::vector<kl::Hash> kl::hash_batch( std::vector<std::string_view> const& messages )
+{
+    static HashLevel const level = Hasher::best_level();
+    std::vector<Hash> results( messages.size() );
+    hash_batch( messages.data(), messages.size(), results.data(), level );
+    return results;
+}
+
+void kl::hash_batch( std::string_view const* messages, size_t count, Hash* results, HashLevel level )
+{
+    level = supported_level( level );
+    if ( level != HashLevel::AVX2 )
+    {
+        Hasher hasher{ level };
+        for ( size_t i = 0; i < count; i++ )
+        {
+            hasher.update( messages[i] );
+            results[i] = hasher.finalize();
+        }
+        return;
+    }
+
+    // Lanes wait for the longest message in their group, so similar sizes are grouped together.
+    std::vector<size_t> order( count );
+    std::iota( order.begin(), order.end(), 0 );
+    std::stable_sort( order.begin(), order.end(), [&]( size_t first, size_t second )
+    {
+        return messages[first].size() < messages[second].size();
+    } );
+
+    for ( size_t i = 0; i < count; i += 8 )
+    {
+        std::string_view const* group[8] = {};
+        Hash* group_results[8] = {};
+        size_t const group_size = std::min<size_t>( 8, count - i );
+        for ( size_t j = 0; j < group_size; j++ )
+        {
+            group[j] = messages + order[i + j];
+            group_results[j] = results + order[i + j];
+        }
+        hash_lanes( group, group_size, group_results );
+    }
+}
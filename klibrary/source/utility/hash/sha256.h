@@ -3,11 +3,49 @@
 #include "utility/hash/hash_t.h"
 
 
+namespace kl
+{
+enum struct HashLevel : int32_t
+{
+    SCALAR = 0,
+    AVX2,
+    SHA,
+};
+}
+
+namespace kl
+{
+// Incremental SHA-256, update() can be called any number of times before finalize().
+// AVX2 only speeds up hash_batch(), single streams use SHA extensions or scalar code.
+struct Hasher
+{
+    Hasher();
+    Hasher( HashLevel level );
+
+    static HashLevel best_level();
+
+    void update( void const* data, uint64_t byte_size );
+    void update( std::string_view const& data );
+    Hash finalize();
+    void reset();
+
+private:
+    HashLevel m_level = HashLevel::SCALAR;
+    uint32_t m_state[8] = {};
+    uint8_t m_buffer[64] = {};
+    uint64_t m_buffer_size = 0;
+    uint64_t m_byte_size = 0;
+};
+}
+
 namespace kl
 {
 Hash hash( void const* data, uint64_t byte_size );
 Hash hash_str( std::string_view const& data );
 
+std::vector<Hash> hash_batch( std::vector<std::string_view> const& messages );
+void hash_batch( std::string_view const* messages, size_t count, Hash* results, HashLevel level );
+
 template<typename T>
 Hash hash_obj( T const& object )
 {
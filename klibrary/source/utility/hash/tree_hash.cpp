@@ -0,0 +1,167 @@
+#include "klibrary.h"
+
+
+static bool hash_file_chunks( kl::TreeHash& tree, std::string_view const& filepath, uint64_t first, uint64_t last )
+{
+    if ( first >= last )
+        return true;
+
+    // Every task reads its own run of chunks through a separate handle so reads and hashing overlap.
+    uint64_t const chunk_count = last - first;
+    uint64_t const range_count = std::min<uint64_t>( chunk_count, uint64_t( std::max( kl::CPU_CORE_COUNT, 1 ) ) * 4 );
+    std::atomic<bool> failed = false;
+    kl::async_for<uint64_t>( 0, range_count, [&]( uint64_t range )
+    {
+        uint64_t const range_first = first + chunk_count * range / range_count;
+        uint64_t const range_last = first + chunk_count * (range + 1) / range_count;
+
+        kl::File file{ filepath, false };
+        if ( !file || !file.seek( int64_t( range_first * tree.chunk_size ) ) )
+        {
+            failed = true;
+            return;
+        }
+
+        std::vector<byte> buffer( tree.chunk_size );
+        for ( uint64_t i = range_first; i < range_last; i++ )
+        {
+            uint64_t const chunk_size = std::min( tree.chunk_size, tree.byte_size - i * tree.chunk_size );
+            if ( file.read( buffer.data(), chunk_size ) != chunk_size )
+            {
+                failed = true;
+                return;
+            }
+            tree.chunks[i] = kl::tree_leaf( buffer.data(), chunk_size );
+        }
+    } );
+    return !failed;
+}
+
+uint64_t kl::TreeHash::chunk_count() const
+{
+    if ( byte_size == 0 )
+        return 1;
+    return (byte_size + chunk_size - 1) / chunk_size;
+}
+
+std::pair<uint64_t, uint64_t> kl::TreeHash::chunk_range( uint64_t offset, uint64_t byte_size ) const
+{
+    uint64_t const count = chunk_count();
+    uint64_t const first = std::min( offset / chunk_size, count );
+    if ( byte_size == 0 )
+        return { first, first };
+    return { first, std::min( (offset + byte_size - 1) / chunk_size + 1, count ) };
+}
+
+void kl::TreeHash::update_root()
+{
+    root = tree_root( chunks );
+}
+
+kl::Hash kl::tree_leaf( void const* data, uint64_t byte_size )
+{
+    static constexpr byte prefix = 0x00;
+    Hasher hasher;
+    hasher.update( &prefix, 1 );
+    hasher.update( data, byte_size );
+    return hasher.finalize();
+}
+
+kl::Hash kl::tree_node( Hash const& left, Hash const& right )
+{
+    static constexpr byte prefix = 0x01;
+    Hasher hasher;
+    hasher.update( &prefix, 1 );
+    hasher.update( left.buffer, sizeof( left.buffer ) );
+    hasher.update( right.buffer, sizeof( right.buffer ) );
+    return hasher.finalize();
+}
+
+kl::Hash kl::tree_root( std::vector<Hash> const& chunks )
+{
+    if ( chunks.empty() )
+        return tree_leaf( nullptr, 0 );
+
+    std::vector<Hash> level = chunks;
+    while ( level.size() > 1 )
+    {
+        size_t const pair_count = level.size() / 2;
+        for ( size_t i = 0; i < pair_count; i++ )
+            level[i] = tree_node( level[i * 2], level[i * 2 + 1] );
+        if ( level.size() % 2 )
+            level[pair_count] = level.back();
+        level.resize( (level.size() + 1) / 2 );
+    }
+    return level.front();
+}
+
+kl::TreeHash kl::tree_hash( void const* data, uint64_t byte_size, uint64_t chunk_size )
+{
+    TreeHash tree;
+    tree.chunk_size = chunk_size;
+    tree.byte_size = byte_size;
+    tree.chunks.resize( tree.chunk_count() );
+
+    byte const* bytes = reinterpret_cast<byte const*>(data);
+    async_for<uint64_t>( 0, tree.chunks.size(), [&]( uint64_t i )
+    {
+        uint64_t const offset = i * chunk_size;
+        tree.chunks[i] = tree_leaf( bytes + offset, std::min( chunk_size, byte_size - offset ) );
+    } );
+    tree.update_root();
+    return tree;
+}
+
+std::optional<kl::TreeHash> kl::tree_hash_file( std::string_view const& filepath, uint64_t chunk_size )
+{
+    std::error_code error;
+    uint64_t const byte_size = std::filesystem::file_size( filepath, error );
+    if ( error )
+        return std::nullopt;
+
+    TreeHash tree;
+    tree.chunk_size = chunk_size;
+    tree.byte_size = byte_size;
+    tree.chunks.resize( tree.chunk_count() );
+    if ( !hash_file_chunks( tree, filepath, 0, tree.chunks.size() ) )
+        return std::nullopt;
+
+    tree.update_root();
+    return tree;
+}
+
+bool kl::rehash_file_range( TreeHash& tree, std::string_view const& filepath, uint64_t offset, uint64_t byte_size )
+{
+    std::error_code error;
+    uint64_t const new_size = std::filesystem::file_size( filepath, error );
+    if ( error )
+        return false;
+
+    uint64_t const old_count = tree.chunk_count();
+    bool const resized = new_size != tree.byte_size;
+    tree.byte_size = new_size;
+    tree.chunks.resize( tree.chunk_count() );
+
+    auto const [first, last] = tree.chunk_range( offset, byte_size );
+    if ( !hash_file_chunks( tree, filepath, first, last ) )
+        return false;
+
+    // The old last chunk and every added chunk change when the file grows or shrinks.
+    if ( resized && !hash_file_chunks( tree, filepath, std::min( old_count, tree.chunks.size() ) - 1, tree.chunks.size() ) )
+        return false;
+
+    tree.update_root();
+    return true;
+}
+
+std::vector<uint64_t> kl::changed_chunks( TreeHash const& first, TreeHash const& second )
+{
+    std::vector<uint64_t> result;
+    uint64_t const count = std::max( first.chunks.size(), second.chunks.size() );
+    for ( uint64_t i = 0; i < count; i++ )
+    {
+        if ( first.chunk_size != second.chunk_size || i >= first.chunks.size() || i >= second.chunks.size() || first.chunks[i] != second.chunks[i] )
+            result.push_back( i );
+    }
+    return result;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "utility/hash/sha256.h"
+
+
+namespace kl
+{
+// Leaves are SHA-256( 0x00 || chunk ), nodes are SHA-256( 0x01 || left || right ) and an odd
+// node moves up a level unchanged. The root depends on the chunk size, so it is not plain SHA-256.
+struct TreeHash
+{
+    static constexpr uint64_t DEFAULT_CHUNK_SIZE = 1024 * 1024;
+
+    uint64_t chunk_size = DEFAULT_CHUNK_SIZE;
+    uint64_t byte_size = 0;
+    std::vector<Hash> chunks;
+    Hash root;
+
+    uint64_t chunk_count() const;
+    std::pair<uint64_t, uint64_t> chunk_range( uint64_t offset, uint64_t byte_size ) const;
+    void update_root();
+};
+}
+
+namespace kl
+{
+Hash tree_leaf( void const* data, uint64_t byte_size );
+Hash tree_node( Hash const& left, Hash const& right );
+Hash tree_root( std::vector<Hash> const& chunks );
+
+TreeHash tree_hash( void const* data, uint64_t byte_size, uint64_t chunk_size = TreeHash::DEFAULT_CHUNK_SIZE );
+std::optional<TreeHash> tree_hash_file( std::string_view const& filepath, uint64_t chunk_size = TreeHash::DEFAULT_CHUNK_SIZE );
+
+bool rehash_file_range( TreeHash& tree, std::string_view const& filepath, uint64_t offset, uint64_t byte_size );
+std::vector<uint64_t> changed_chunks( TreeHash const& first, TreeHash const& second );
+}
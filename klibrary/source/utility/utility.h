@@ -1,9 +1,15 @@
 #pragma once
 
+#include "utility/async/thread_pool.h"
 #include "utility/async/async.h"
+#include "utility/async/task_graph.h"
+#include "utility/async/coroutine.h"
+#include "utility/cpu/cpu.h"
 #include "utility/data/random.h"
 #include "utility/data/encryptor.h"
 #include "utility/hash/hash_t.h"
 #include "utility/hash/sha256.h"
+#include "utility/hash/tree_hash.h"
+#include "utility/hash/fast_hash.h"
 #include "utility/format/strings.h"
 #include "utility/format/console.h"